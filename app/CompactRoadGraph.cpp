@@ -0,0 +1,487 @@
+// CompactRoadGraph.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include "CompactRoadGraph.hpp"
+#include "FastInputScanner.hpp"
+#include "TraceRecorder.hpp"
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+namespace
+{
+    // Computes the time column, timeWeights[i] = miles[i] / milesPerHour[i],
+    // several lanes at a time where the target supports it.  Each lane is
+    // an ordinary IEEE division, so the result is identical to the scalar
+    // loop that finishes off the tail.  A closed segment, whose speed is
+    // 0, takes forever to drive, even when it's 0 miles long and the
+    // division alone would give NaN.
+    void computeTimeWeights(
+        const double* miles, const double* milesPerHour, double* timeWeights, int count)
+    {
+        const double forever = std::numeric_limits<double>::infinity();
+        int i = 0;
+
+#if defined(__AVX__)
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d infinity = _mm256_set1_pd(forever);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256d speed = _mm256_loadu_pd(milesPerHour + i);
+            __m256d closed = _mm256_cmp_pd(speed, zero, _CMP_EQ_OQ);
+            __m256d quotient = _mm256_div_pd(_mm256_loadu_pd(miles + i), speed);
+            _mm256_storeu_pd(timeWeights + i, _mm256_blendv_pd(quotient, infinity, closed));
+        }
+#elif defined(__SSE2__)
+        const __m128d zero = _mm_setzero_pd();
+        const __m128d infinity = _mm_set1_pd(forever);
+
+        for (; i + 2 <= count; i += 2)
+        {
+            __m128d speed = _mm_loadu_pd(milesPerHour + i);
+            __m128d closed = _mm_cmpeq_pd(speed, zero);
+            __m128d quotient = _mm_div_pd(_mm_loadu_pd(miles + i), speed);
+            _mm_storeu_pd(
+                timeWeights + i,
+                _mm_or_pd(_mm_andnot_pd(closed, quotient), _mm_and_pd(closed, infinity)));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            timeWeights[i] = milesPerHour[i] == 0.0 ? forever : miles[i] / milesPerHour[i];
+        }
+    }
+}
+
+
+CompactRoadGraph::CompactRoadGraph()
+{
+    owned_.offsets.push_back(0);
+    owned_.reverseOffsets.push_back(0);
+    useOwnedColumns();
+}
+
+
+CompactRoadGraph::CompactRoadGraph(const RoadMap& roadMap)
+{
+    TraceSpan span{"freeze road map"};
+
+    NameTable names;
+    names.reserve(roadMap.vertexCount(), 0);
+
+    owned_.sources.reserve(roadMap.edgeCount());
+    owned_.targets.reserve(roadMap.edgeCount());
+    owned_.miles.reserve(roadMap.edgeCount());
+    owned_.milesPerHour.reserve(roadMap.edgeCount());
+
+    // Vertices are visited in increasing order, so they're numbered
+    // 0..N-1 exactly when each one's number is the count seen before it.
+    roadMap.forEachVertex(
+        [&](int vertex, const std::string& name)
+        {
+            if (vertex != names.size())
+            {
+                throw DigraphException("A RoadMap can only be frozen if its vertices are numbered 0..N-1");
+            }
+
+            names.add(name);
+
+            roadMap.forEachOutEdge(
+                vertex,
+                [&](const DigraphEdge<RoadSegment>& edge)
+                {
+                    owned_.sources.push_back(edge.fromVertex);
+                    owned_.targets.push_back(edge.toVertex);
+                    owned_.miles.push_back(edge.einfo.miles);
+                    owned_.milesPerHour.push_back(edge.einfo.milesPerHour);
+                });
+        });
+
+    build(std::move(names));
+}
+
+
+CompactRoadGraph::CompactRoadGraph(
+    NameTable names, std::vector<int> sources,
+    std::vector<int> targets, std::vector<double> miles,
+    std::vector<double> milesPerHour)
+{
+    owned_.sources = std::move(sources);
+    owned_.targets = std::move(targets);
+    owned_.miles = std::move(miles);
+    owned_.milesPerHour = std::move(milesPerHour);
+    build(std::move(names));
+}
+
+
+CompactRoadGraph::CompactRoadGraph(
+    const CompactRoadColumns& columns, std::shared_ptr<const void> mapping)
+    : vertexCount_{columns.vertexCount}, edgeCount_{columns.edgeCount},
+      offsets_{columns.offsets}, sources_{columns.sources}, targets_{columns.targets},
+      miles_{columns.miles}, milesPerHour_{columns.milesPerHour},
+      timeWeights_{columns.timeWeights}, reverseOffsets_{columns.reverseOffsets},
+      reverseEdges_{columns.reverseEdges}, nameOffsets_{columns.nameOffsets},
+      nameChars_{columns.nameChars}, mapping_{std::move(mapping)}
+{
+    recomputeDistanceWeights();
+}
+
+
+CompactRoadColumns CompactRoadGraph::columns() const
+{
+    return CompactRoadColumns{
+        vertexCount_, edgeCount_, offsets_, sources_, targets_, miles_,
+        milesPerHour_, timeWeights_, reverseOffsets_, reverseEdges_,
+        nameOffsets_, nameChars_};
+}
+
+
+void CompactRoadGraph::build(NameTable names)
+{
+    TraceSpan span{"build graph"};
+
+    int vertexCount = names.size();
+    int edgeCount = static_cast<int>(owned_.targets.size());
+
+    std::vector<int>& sources = owned_.sources;
+    std::vector<int>& targets = owned_.targets;
+    std::vector<int>& offsets = owned_.offsets;
+
+    for (int edge = 0; edge < edgeCount; ++edge)
+    {
+        if (sources[edge] < 0 || sources[edge] >= vertexCount
+            || targets[edge] < 0 || targets[edge] >= vertexCount)
+        {
+            throw DigraphException("One of the vertices does not exist");
+        }
+    }
+
+    // The names are already laid end to end in one block of characters.
+    owned_.names = std::move(names);
+
+    offsets.assign(vertexCount + 1, 0);
+
+    for (int source : sources)
+    {
+        ++offsets[source + 1];
+    }
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        offsets[vertex + 1] += offsets[vertex];
+    }
+
+    // Edges that don't arrive grouped by source are put in order with a
+    // stable counting sort, applied to every column.
+    if (!std::is_sorted(sources.begin(), sources.end()))
+    {
+        std::vector<int> order(edgeCount);
+        std::vector<int> nextPosition(offsets.begin(), offsets.end() - 1);
+
+        for (int edge = 0; edge < edgeCount; ++edge)
+        {
+            order[nextPosition[sources[edge]]++] = edge;
+        }
+
+        std::vector<int> sortedSources(edgeCount);
+        std::vector<int> sortedTargets(edgeCount);
+        std::vector<double> sortedMiles(edgeCount);
+        std::vector<double> sortedMilesPerHour(edgeCount);
+
+        for (int position = 0; position < edgeCount; ++position)
+        {
+            sortedSources[position] = sources[order[position]];
+            sortedTargets[position] = targets[order[position]];
+            sortedMiles[position] = owned_.miles[order[position]];
+            sortedMilesPerHour[position] = owned_.milesPerHour[order[position]];
+        }
+
+        sources.swap(sortedSources);
+        targets.swap(sortedTargets);
+        owned_.miles.swap(sortedMiles);
+        owned_.milesPerHour.swap(sortedMilesPerHour);
+    }
+
+    // A target seen twice among one vertex's edges is a duplicate edge.
+    std::vector<int> seenFrom(vertexCount, -1);
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        for (int edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge)
+        {
+            if (seenFrom[targets[edge]] == vertex)
+            {
+                throw DigraphException("the same edge is already present in the graph");
+            }
+
+            seenFrom[targets[edge]] = vertex;
+        }
+    }
+
+    owned_.timeWeights.resize(edgeCount);
+    computeTimeWeights(
+        owned_.miles.data(), owned_.milesPerHour.data(), owned_.timeWeights.data(), edgeCount);
+
+    // The reverse adjacency is a counting sort of the edges by target.
+    std::vector<int>& reverseOffsets = owned_.reverseOffsets;
+    reverseOffsets.assign(vertexCount + 1, 0);
+    owned_.reverseEdges.resize(edgeCount);
+
+    for (int target : targets)
+    {
+        ++reverseOffsets[target + 1];
+    }
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        reverseOffsets[vertex + 1] += reverseOffsets[vertex];
+    }
+
+    std::vector<int> nextPosition(reverseOffsets.begin(), reverseOffsets.end() - 1);
+
+    for (int edge = 0; edge < edgeCount; ++edge)
+    {
+        owned_.reverseEdges[nextPosition[targets[edge]]++] = edge;
+    }
+
+    useOwnedColumns();
+}
+
+
+void CompactRoadGraph::useOwnedColumns()
+{
+    vertexCount_ = static_cast<int>(owned_.offsets.size()) - 1;
+    edgeCount_ = static_cast<int>(owned_.targets.size());
+    offsets_ = owned_.offsets.data();
+    sources_ = owned_.sources.data();
+    targets_ = owned_.targets.data();
+    miles_ = owned_.miles.data();
+    milesPerHour_ = owned_.milesPerHour.data();
+    timeWeights_ = owned_.timeWeights.data();
+    reverseOffsets_ = owned_.reverseOffsets.data();
+    reverseEdges_ = owned_.reverseEdges.data();
+    nameOffsets_ = owned_.names.offsets().data();
+    nameChars_ = owned_.names.chars().data();
+    recomputeDistanceWeights();
+}
+
+
+std::vector<int> CompactRoadGraph::updateSpeeds(const std::vector<SpeedUpdate>& updates)
+{
+    std::vector<int> edges;
+    edges.reserve(updates.size());
+
+    for (const SpeedUpdate& update : updates)
+    {
+        int edge = findEdge(update.fromVertex, update.toVertex);
+
+        if (edge < 0)
+        {
+            throw DigraphException("Edge does not exist or one of those vertices does not exist");
+        }
+
+        // The searches and the tree repair assume that no weight is
+        // negative; a speed of 0 is a closed road, whose time is infinite.
+        if (!(update.milesPerHour >= 0.0))
+        {
+            throw InputFormatException(
+                "Speed must be a non-negative number but found "
+                + std::to_string(update.milesPerHour));
+        }
+
+        edges.push_back(edge);
+    }
+
+    // A graph viewing a mapped snapshot can't write into the mapping, so
+    // it takes its own copy of the two columns that speeds change.
+    if (milesPerHour_ != owned_.milesPerHour.data())
+    {
+        owned_.milesPerHour.assign(milesPerHour_, milesPerHour_ + edgeCount_);
+        milesPerHour_ = owned_.milesPerHour.data();
+    }
+
+    for (int i = 0; i < static_cast<int>(updates.size()); ++i)
+    {
+        owned_.milesPerHour[edges[i]] = updates[i].milesPerHour;
+    }
+
+    recomputeWeightColumns();
+    return edges;
+}
+
+
+void CompactRoadGraph::recomputeWeightColumns()
+{
+    if (timeWeights_ != owned_.timeWeights.data())
+    {
+        owned_.timeWeights.resize(edgeCount_);
+        timeWeights_ = owned_.timeWeights.data();
+    }
+
+    computeTimeWeights(miles_, milesPerHour_, owned_.timeWeights.data(), edgeCount_);
+    recomputeDistanceWeights();
+}
+
+
+void CompactRoadGraph::recomputeDistanceWeights()
+{
+    const double* closed = std::find(milesPerHour_, milesPerHour_ + edgeCount_, 0.0);
+
+    if (closed == milesPerHour_ + edgeCount_)
+    {
+        owned_.distanceWeights.clear();
+        distanceWeights_ = miles_;
+        return;
+    }
+
+    owned_.distanceWeights.assign(miles_, miles_ + edgeCount_);
+
+    for (int edge = static_cast<int>(closed - milesPerHour_); edge < edgeCount_; ++edge)
+    {
+        if (milesPerHour_[edge] == 0.0)
+        {
+            owned_.distanceWeights[edge] = std::numeric_limits<double>::infinity();
+        }
+    }
+
+    distanceWeights_ = owned_.distanceWeights.data();
+}
+
+
+int CompactRoadGraph::findEdge(int fromVertex, int toVertex) const
+{
+    if (!hasVertex(fromVertex))
+    {
+        return -1;
+    }
+
+    for (int edge = edgeBegin(fromVertex); edge < edgeEnd(fromVertex); ++edge)
+    {
+        if (targets_[edge] == toVertex)
+        {
+            return edge;
+        }
+    }
+
+    return -1;
+}
+
+
+RoadSegment CompactRoadGraph::edgeInfo(int fromVertex, int toVertex) const
+{
+    int edge = findEdge(fromVertex, toVertex);
+
+    if (edge < 0)
+    {
+        throw DigraphException("Edge does not exist or one of those vertices does not exist");
+    }
+
+    return edgeInfo(edge);
+}
+
+
+std::string_view CompactRoadGraph::vertexName(int vertex) const
+{
+    if (!hasVertex(vertex))
+    {
+        throw DigraphException("Vertex does not exist.");
+    }
+
+    return std::string_view{
+        nameChars_ + nameOffsets_[vertex],
+        static_cast<std::size_t>(nameOffsets_[vertex + 1] - nameOffsets_[vertex])};
+}
+
+
+std::string CompactRoadGraph::vertexInfo(int vertex) const
+{
+    return std::string{vertexName(vertex)};
+}
+
+
+// The running totals are summed stop by stop in route order, so they come
+// out exactly as if the stops' segments were added up afterward.
+Route CompactRoadGraph::makeRoute(int startVertex, const std::vector<int>& edges) const
+{
+    TraceSpan span{"extract route"};
+
+    Route route;
+    route.stops.reserve(edges.size() + 1);
+    route.stops.push_back(
+        RouteStop{startVertex, -1, vertexName(startVertex), RoadSegment{0.0, 0.0}, 0.0, 0.0});
+
+    double miles = 0.0;
+    double seconds = 0.0;
+
+    for (int edge : edges)
+    {
+        int vertex = targets_[edge];
+        miles += miles_[edge];
+        seconds += timeWeights_[edge] * 3600;
+
+        route.stops.push_back(
+            RouteStop{
+                vertex, edge,
+                std::string_view{
+                    nameChars_ + nameOffsets_[vertex],
+                    static_cast<std::size_t>(nameOffsets_[vertex + 1] - nameOffsets_[vertex])},
+                RoadSegment{miles_[edge], milesPerHour_[edge]},
+                miles, seconds});
+    }
+
+    return route;
+}
+
+
+std::vector<int> CompactRoadGraph::findShortestPaths(
+    int startVertex,
+    std::function<double(const RoadSegment&)> edgeWeightFunc) const
+{
+    return findShortestPathTree(startVertex, edgeWeightFunc).predecessors;
+}
+
+
+CompactPaths CompactRoadGraph::findShortestPathTree(
+    int startVertex,
+    std::function<double(const RoadSegment&)> edgeWeightFunc) const
+{
+    return findShortestPathTree<std::function<double(const RoadSegment&)>>(
+        startVertex, edgeWeightFunc);
+}
+
+
+Route CompactRoadGraph::findShortestPath(
+    int startVertex, int endVertex,
+    std::function<double(const RoadSegment&)> edgeWeightFunc) const
+{
+    return findShortestPath<std::function<double(const RoadSegment&)>>(
+        startVertex, endVertex, edgeWeightFunc);
+}
+
+
+Route CompactRoadGraph::findShortestPathBidirectional(
+    int startVertex, int endVertex,
+    std::function<double(const RoadSegment&)> edgeWeightFunc) const
+{
+    return findShortestPathBidirectional<std::function<double(const RoadSegment&)>>(
+        startVertex, endVertex, edgeWeightFunc);
+}
+
+
+void CompactRoadGraph::checkEndpoints(int startVertex, int endVertex) const
+{
+    if (!hasVertex(startVertex) || !hasVertex(endVertex))
+    {
+        throw DigraphException("Vertex does not exist.");
+    }
+}
@@ -0,0 +1,688 @@
+// CompactRoadGraph.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A CompactRoadGraph is a frozen, read-only snapshot of a RoadMap laid out
+// in compressed-sparse-row (CSR) form.  The outgoing edges of vertex v are
+// the edge indices in [offsets[v], offsets[v + 1]), and each edge's target
+// vertex, miles and miles per hour are stored in separate contiguous
+// columns, so a search touches a handful of flat arrays instead of chasing
+// the tree and list nodes inside a Digraph.
+//
+// The snapshot also keeps the reverse adjacency in the same form: the
+// incoming edges of vertex v are listed in [reverseOffsets[v],
+// reverseOffsets[v + 1]) as indices into the forward edge columns, which is
+// what backward searches walk.
+//
+// Next to the edge columns, the snapshot keeps one precomputed weight
+// column per TripMetric (miles, and hours of driving time), so a search
+// with DistanceWeight or TimeWeight reads one double per edge instead of
+// recomputing miles / milesPerHour on every relaxation.  A segment whose
+// speed is 0 is closed, and weighs infinitely much in both columns (see
+// TripWeights.hpp).  While no segment is closed, the distance column is
+// simply the miles column.
+//
+// The columns are read through plain pointers, so that a CompactRoadGraph
+// can either own them or view them in place inside a mapped binary
+// snapshot (see RoadMapSnapshot.hpp), with no parsing or allocation.
+//
+// A CompactRoadGraph is built with freeze() once a RoadMap has been read.
+// Its shape doesn't change afterward; if vertices or edges are added to or
+// removed from the RoadMap, freeze it again.  Speeds are the exception:
+// updateSpeeds() changes milesPerHour on existing edges in bulk and
+// refreshes the weight columns to match.
+
+#ifndef COMPACTROADGRAPH_HPP
+#define COMPACTROADGRAPH_HPP
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "NameTable.hpp"
+#include "QueryWorkspace.hpp"
+#include "RoadMap.hpp"
+#include "RoadSegment.hpp"
+#include "Route.hpp"
+#include "SearchCounters.hpp"
+#include "SpeedUpdate.hpp"
+#include "TripMetric.hpp"
+#include "TripWeights.hpp"
+
+
+
+// A CompactPaths is the result of a single-source search over a
+// CompactRoadGraph, indexed by vertex number.  It follows the same
+// conventions as DigraphPaths: a vertex without a predecessor is its own
+// predecessor, and a vertex that was never reached has an infinite distance.
+// predecessorEdges names the edge index through which each vertex was
+// reached, or -1 if it has no predecessor.  counters tally the work the
+// search did (see SearchCounters.hpp).
+
+struct CompactPaths
+{
+    std::vector<int> predecessors;
+    std::vector<int> predecessorEdges;
+    std::vector<double> distances;
+    SearchCounters counters;
+};
+
+
+
+// A CompactRoadColumns points at every column of a CompactRoadGraph.  It
+// is how a graph is written to and read from a binary snapshot (see
+// RoadMapSnapshot.hpp).  The name of vertex v is the characters in
+// [nameChars + nameOffsets[v], nameChars + nameOffsets[v + 1]).
+
+struct CompactRoadColumns
+{
+    int vertexCount;
+    int edgeCount;
+    const int* offsets;
+    const int* sources;
+    const int* targets;
+    const double* miles;
+    const double* milesPerHour;
+    const double* timeWeights;
+    const int* reverseOffsets;
+    const int* reverseEdges;
+    const std::int64_t* nameOffsets;
+    const char* nameChars;
+};
+
+
+
+class CompactRoadGraph
+{
+public:
+    // The default constructor initializes an empty CompactRoadGraph.
+    CompactRoadGraph();
+
+    // This constructor builds a CompactRoadGraph from the given RoadMap.
+    // The RoadMap's vertices must be numbered 0..N-1, as RoadMapReader
+    // numbers them; otherwise, a DigraphException is thrown.  Outgoing
+    // edges keep the order in which they were added to the RoadMap.
+    explicit CompactRoadGraph(const RoadMap& roadMap);
+
+    // This constructor builds a CompactRoadGraph straight from vertex
+    // names and edge columns, without going through a RoadMap; vertex i is
+    // named names.name(i), and edge i points from sources[i] to targets[i].
+    // Edges from the same vertex keep their relative order.  If an edge
+    // names a vertex that does not exist, or the same edge appears twice,
+    // a DigraphException is thrown.
+    CompactRoadGraph(
+        NameTable names, std::vector<int> sources,
+        std::vector<int> targets, std::vector<double> miles,
+        std::vector<double> milesPerHour);
+
+    // This constructor makes a CompactRoadGraph that reads its columns
+    // in place from memory it doesn't own, such as a mapped snapshot
+    // file; the given mapping is kept alive for as long as the graph is.
+    CompactRoadGraph(const CompactRoadColumns& columns, std::shared_ptr<const void> mapping);
+
+    // A CompactRoadGraph can be moved but not copied, since a copy would
+    // share the columns it reads with the original.
+    CompactRoadGraph(const CompactRoadGraph&) = delete;
+    CompactRoadGraph(CompactRoadGraph&&) = default;
+    CompactRoadGraph& operator=(const CompactRoadGraph&) = delete;
+    CompactRoadGraph& operator=(CompactRoadGraph&&) = default;
+
+    // columns() returns pointers to every column of the graph, which stay
+    // valid until the graph is changed, moved or destroyed.
+    CompactRoadColumns columns() const;
+
+    // vertexCount() returns the number of vertices in the graph.
+    int vertexCount() const { return vertexCount_; }
+
+    // edgeCount() returns the number of edges in the graph.
+    int edgeCount() const { return edgeCount_; }
+
+    // edgeBegin() and edgeEnd() return the range of edge indices holding
+    // the outgoing edges of the given vertex.
+    int edgeBegin(int vertex) const { return offsets_[vertex]; }
+    int edgeEnd(int vertex) const { return offsets_[vertex + 1]; }
+
+    // reverseEdgeBegin() and reverseEdgeEnd() return the range of
+    // positions holding the incoming edges of the given vertex, and
+    // reverseEdge() returns the edge index stored at such a position.
+    int reverseEdgeBegin(int vertex) const { return reverseOffsets_[vertex]; }
+    int reverseEdgeEnd(int vertex) const { return reverseOffsets_[vertex + 1]; }
+    int reverseEdge(int position) const { return reverseEdges_[position]; }
+
+    // edgeSource() returns the vertex from which the edge with the given
+    // edge index points.
+    int edgeSource(int edge) const { return sources_[edge]; }
+
+    // edgeTarget(), edgeMiles() and edgeMilesPerHour() return the columns
+    // of the edge with the given edge index.
+    int edgeTarget(int edge) const { return targets_[edge]; }
+    double edgeMiles(int edge) const { return miles_[edge]; }
+    double edgeMilesPerHour(int edge) const { return milesPerHour_[edge]; }
+
+    // This overload of edgeInfo() reassembles the RoadSegment of the edge
+    // with the given edge index.
+    RoadSegment edgeInfo(int edge) const
+    {
+        return RoadSegment{miles_[edge], milesPerHour_[edge]};
+    }
+
+    // weightColumn() returns the precomputed weight column for the given
+    // TripMetric, indexed by edge index: miles for TripMetric::Distance
+    // and hours for TripMetric::Time, or infinity for a closed segment.
+    const double* weightColumn(TripMetric metric) const
+    {
+        return metric == TripMetric::Distance ? distanceWeights_ : timeWeights_;
+    }
+
+    // updateSpeeds() sets milesPerHour on the edge named by each of the
+    // given updates, then recomputes the weight columns in one pass.  It
+    // returns the edge index of each update, in the same order.  If an
+    // update names an edge that does not exist, a DigraphException is
+    // thrown, and if its speed is negative or not a number, an
+    // InputFormatException is thrown; either way, none of the updates are
+    // applied.
+    std::vector<int> updateSpeeds(const std::vector<SpeedUpdate>& updates);
+
+    // recomputeWeightColumns() rebuilds the whole time and distance
+    // columns from the miles and milesPerHour columns.
+    void recomputeWeightColumns();
+
+    // findEdge() returns the index of the edge from the given "from" vertex
+    // to the given "to" vertex, or -1 if there is no such edge.
+    int findEdge(int fromVertex, int toVertex) const;
+
+    // edgeInfo() returns the RoadSegment belonging to the edge with the
+    // given "from" and "to" vertex numbers.  If either vertex or the edge
+    // does not exist, a DigraphException is thrown instead.
+    RoadSegment edgeInfo(int fromVertex, int toVertex) const;
+
+    // hasVertex() returns true if the given vertex number is in the graph.
+    bool hasVertex(int vertex) const
+    {
+        return vertex >= 0 && vertex < vertexCount();
+    }
+
+    // vertexName() returns the name of the vertex with the given vertex
+    // number, as a view into the graph's name column that stays valid for
+    // as long as the graph does.  If that vertex does not exist, a
+    // DigraphException is thrown instead.
+    std::string_view vertexName(int vertex) const;
+
+    // vertexInfo() returns a copy of the name of the vertex with the given
+    // vertex number, like Digraph::vertexInfo().  If that vertex does not
+    // exist, a DigraphException is thrown instead.
+    std::string vertexInfo(int vertex) const;
+
+    // makeRoute() returns the Route that starts at the given vertex and
+    // follows the edges with the given edge indices in order, each of which
+    // must leave the vertex the previous one entered.  Every stop is read
+    // straight out of the columns, so no edge is looked up by its endpoints.
+    Route makeRoute(int startVertex, const std::vector<int>& edges) const;
+
+    // findShortestPaths() behaves like Digraph::findShortestPaths(),
+    // except that the predecessors are returned as a std::vector indexed
+    // by vertex number.
+    std::vector<int> findShortestPaths(
+        int startVertex,
+        std::function<double(const RoadSegment&)> edgeWeightFunc) const;
+
+    // findShortestPathTree() behaves like Digraph::findShortestPathTree(),
+    // returning the predecessors and distance labels of every vertex.
+    CompactPaths findShortestPathTree(
+        int startVertex,
+        std::function<double(const RoadSegment&)> edgeWeightFunc) const;
+
+    // This overload of findShortestPathTree() takes the edge weight
+    // function as a template parameter, so that a functor is inlined into
+    // the relaxation loop instead of being called through a std::function.
+    // DistanceWeight and TimeWeight read the precomputed weight columns.
+    template <typename EdgeWeightFunc>
+    CompactPaths findShortestPathTree(
+        int startVertex, EdgeWeightFunc edgeWeightFunc) const;
+
+    // findShortestPath() returns the Route along a shortest path from the
+    // start vertex to the end vertex, or an empty Route if the end vertex
+    // can't be reached.  The search stops as soon as the end vertex is
+    // settled, and the Route is built from the predecessor edges it
+    // recorded.  If either vertex does not exist, a DigraphException is
+    // thrown instead.
+    Route findShortestPath(
+        int startVertex, int endVertex,
+        std::function<double(const RoadSegment&)> edgeWeightFunc) const;
+
+    // This overload of findShortestPath() takes the edge weight function
+    // as a template parameter.
+    template <typename EdgeWeightFunc>
+    Route findShortestPath(
+        int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc) const;
+
+    // This overload of findShortestPath() keeps its labels in the given
+    // workspace instead of allocating arrays for them, so that a worker
+    // answering many trips sets up each search in constant time.
+    template <typename EdgeWeightFunc>
+    Route findShortestPath(
+        int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc,
+        QueryWorkspace& workspace) const;
+
+    // findShortestPathBidirectional() returns the same kind of Route as
+    // findShortestPath(), but searches forward from the start vertex and
+    // backward from the end vertex at the same time, stopping once the two
+    // frontiers have met and no shorter connection remains possible.
+    Route findShortestPathBidirectional(
+        int startVertex, int endVertex,
+        std::function<double(const RoadSegment&)> edgeWeightFunc) const;
+
+    // This overload of findShortestPathBidirectional() takes the edge
+    // weight function as a template parameter.
+    template <typename EdgeWeightFunc>
+    Route findShortestPathBidirectional(
+        int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc) const;
+
+    // This overload of findShortestPathBidirectional() keeps the labels of
+    // the two searches in the given workspaces.
+    template <typename EdgeWeightFunc>
+    Route findShortestPathBidirectional(
+        int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc,
+        QueryWorkspace& forwardWorkspace, QueryWorkspace& backwardWorkspace) const;
+
+    // findShortestPathGuided() returns the same kind of Route as
+    // findShortestPath() with an A* search: vertices are settled in order
+    // of their distance from the start vertex plus heuristic(vertex),
+    // which must be a lower bound on the vertex's distance to the end
+    // vertex that never drops by more than an edge's weight across that
+    // edge, such as a LandmarkIndex::Heuristic.  A vertex whose bound is
+    // infinite is known not to reach the end vertex and is never visited.
+    // The labels are kept in the given workspace.
+    template <typename EdgeWeightFunc, typename Heuristic>
+    Route findShortestPathGuided(
+        int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc,
+        Heuristic heuristic, QueryWorkspace& workspace) const;
+
+private:
+    typedef QueryWorkspace::QueueEntry QueueEntry;
+
+    typedef std::priority_queue<
+        QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> SearchQueue;
+
+    // A WeightColumn reads edge weights straight out of one of the
+    // precomputed weight columns.
+    struct WeightColumn
+    {
+        const double* weights;
+
+        double operator()(int edge) const { return weights[edge]; }
+    };
+
+    // edgeWeights() adapts an edge weight function into a function of edge
+    // indices.  DistanceWeight and TimeWeight become a WeightColumn; any
+    // other function is called with the edge's RoadSegment.
+    template <typename EdgeWeightFunc>
+    auto edgeWeights(EdgeWeightFunc edgeWeightFunc) const
+    {
+        return [this, edgeWeightFunc](int edge) { return edgeWeightFunc(edgeInfo(edge)); };
+    }
+
+    WeightColumn edgeWeights(DistanceWeight) const { return WeightColumn{distanceWeights_}; }
+    WeightColumn edgeWeights(TimeWeight) const { return WeightColumn{timeWeights_}; }
+
+    // build() sorts the owned edge columns by source vertex, takes over
+    // the given names, and derives the offsets, the time column and the
+    // reverse adjacency.
+    void build(NameTable names);
+
+    // useOwnedColumns() points every column at owned_.
+    void useOwnedColumns();
+
+    // recomputeDistanceWeights() points the distance column at the miles
+    // column, or, if any segment is closed, at an owned copy of it in
+    // which the closed segments weigh infinitely much.
+    void recomputeDistanceWeights();
+
+    void checkEndpoints(int startVertex, int endVertex) const;
+
+private:
+    // The columns of a graph built in memory.  A graph viewing a mapped
+    // snapshot leaves these empty, except for columns that it has had to
+    // copy in order to change them.
+    struct OwnedColumns
+    {
+        std::vector<int> offsets;
+        std::vector<int> sources;
+        std::vector<int> targets;
+        std::vector<double> miles;
+        std::vector<double> milesPerHour;
+        std::vector<double> timeWeights;
+        std::vector<double> distanceWeights;
+        std::vector<int> reverseOffsets;
+        std::vector<int> reverseEdges;
+        NameTable names;
+    };
+
+    // Every column is read through one of these pointers, which point
+    // either into owned_ or into the snapshot kept alive by mapping_.
+    int vertexCount_;
+    int edgeCount_;
+    const int* offsets_;
+    const int* sources_;
+    const int* targets_;
+    const double* miles_;
+    const double* milesPerHour_;
+    const double* timeWeights_;
+    const double* distanceWeights_;
+    const int* reverseOffsets_;
+    const int* reverseEdges_;
+    const std::int64_t* nameOffsets_;
+    const char* nameChars_;
+
+    OwnedColumns owned_;
+    std::shared_ptr<const void> mapping_;
+};
+
+
+
+// freeze() turns a built RoadMap into a CompactRoadGraph, which is the
+// layout every query in the program runs against.
+inline CompactRoadGraph freeze(const RoadMap& roadMap)
+{
+    return CompactRoadGraph{roadMap};
+}
+
+
+
+template <typename EdgeWeightFunc>
+CompactPaths CompactRoadGraph::findShortestPathTree(
+    int startVertex, EdgeWeightFunc edgeWeightFunc) const
+{
+    auto weight = edgeWeights(edgeWeightFunc);
+
+    if (!hasVertex(startVertex))
+    {
+        throw DigraphException("Start vertex does not exist.");
+    }
+
+    CompactPaths paths;
+    paths.predecessors.resize(vertexCount());
+    paths.predecessorEdges.assign(vertexCount(), -1);
+    paths.distances.assign(vertexCount(), std::numeric_limits<double>::infinity());
+
+    for (int vertex = 0; vertex < vertexCount(); ++vertex)
+    {
+        paths.predecessors[vertex] = vertex;
+    }
+
+    SearchQueue queue;
+
+    paths.distances[startVertex] = 0.0;
+    queue.push(QueueEntry{0.0, startVertex});
+    paths.counters.countPush();
+
+    while (!queue.empty())
+    {
+        QueueEntry smallest = queue.top();
+        queue.pop();
+
+        int vertex = smallest.second;
+
+        if (smallest.first > paths.distances[vertex])
+        {
+            paths.counters.countStalePop();
+            continue;
+        }
+
+        paths.counters.countSettled();
+
+        for (int edge = offsets_[vertex]; edge < offsets_[vertex + 1]; ++edge)
+        {
+            int target = targets_[edge];
+            double candidate = smallest.first + weight(edge);
+
+            paths.counters.countRelaxed();
+
+            if (candidate < paths.distances[target])
+            {
+                paths.distances[target] = candidate;
+                paths.predecessors[target] = vertex;
+                paths.predecessorEdges[target] = edge;
+                queue.push(QueueEntry{candidate, target});
+                paths.counters.countPush();
+            }
+        }
+    }
+
+    return paths;
+}
+
+
+template <typename EdgeWeightFunc>
+Route CompactRoadGraph::findShortestPath(
+    int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc) const
+{
+    QueryWorkspace workspace;
+    return findShortestPath(startVertex, endVertex, edgeWeightFunc, workspace);
+}
+
+
+template <typename EdgeWeightFunc>
+Route CompactRoadGraph::findShortestPath(
+    int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc,
+    QueryWorkspace& workspace) const
+{
+    auto weight = edgeWeights(edgeWeightFunc);
+
+    checkEndpoints(startVertex, endVertex);
+
+    workspace.prepare(vertexCount());
+    workspace.label(startVertex, 0.0, startVertex, -1);
+    workspace.push(QueueEntry{0.0, startVertex});
+
+    while (!workspace.queueEmpty())
+    {
+        QueueEntry smallest = workspace.queueTop();
+        workspace.pop();
+
+        int vertex = smallest.second;
+
+        if (smallest.first > workspace.distance(vertex))
+        {
+            workspace.counters().countStalePop();
+            continue;
+        }
+
+        workspace.counters().countSettled();
+
+        if (vertex == endVertex)
+        {
+            return makeRoute(startVertex, workspace.traceEdges(startVertex, endVertex));
+        }
+
+        for (int edge = offsets_[vertex]; edge < offsets_[vertex + 1]; ++edge)
+        {
+            int target = targets_[edge];
+            double candidate = smallest.first + weight(edge);
+
+            workspace.counters().countRelaxed();
+
+            if (candidate < workspace.distance(target))
+            {
+                workspace.label(target, candidate, vertex, edge);
+                workspace.push(QueueEntry{candidate, target});
+            }
+        }
+    }
+
+    return Route{};
+}
+
+
+template <typename EdgeWeightFunc>
+Route CompactRoadGraph::findShortestPathBidirectional(
+    int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc) const
+{
+    QueryWorkspace forwardWorkspace;
+    QueryWorkspace backwardWorkspace;
+
+    return findShortestPathBidirectional(
+        startVertex, endVertex, edgeWeightFunc, forwardWorkspace, backwardWorkspace);
+}
+
+
+// The bidirectional search alternates between the two frontiers, always
+// advancing the one whose smallest label is lower.  Every time a label
+// improves on either side, the vertex is checked as a meeting point, and
+// the search stops when the two smallest labels add up to at least the
+// best connection found so far, since no undiscovered path can beat it.
+template <typename EdgeWeightFunc>
+Route CompactRoadGraph::findShortestPathBidirectional(
+    int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc,
+    QueryWorkspace& forwardWorkspace, QueryWorkspace& backwardWorkspace) const
+{
+    auto weight = edgeWeights(edgeWeightFunc);
+
+    checkEndpoints(startVertex, endVertex);
+
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    forwardWorkspace.prepare(vertexCount());
+    backwardWorkspace.prepare(vertexCount());
+    forwardWorkspace.label(startVertex, 0.0, startVertex, -1);
+    backwardWorkspace.label(endVertex, 0.0, endVertex, -1);
+    forwardWorkspace.push(QueueEntry{0.0, startVertex});
+    backwardWorkspace.push(QueueEntry{0.0, endVertex});
+
+    double best = startVertex == endVertex ? 0.0 : infinity;
+    int meeting = startVertex == endVertex ? startVertex : -1;
+
+    while (!forwardWorkspace.queueEmpty() && !backwardWorkspace.queueEmpty()
+           && forwardWorkspace.queueTop().first + backwardWorkspace.queueTop().first < best)
+    {
+        bool forward = forwardWorkspace.queueTop().first <= backwardWorkspace.queueTop().first;
+        QueryWorkspace& workspace = forward ? forwardWorkspace : backwardWorkspace;
+        QueryWorkspace& otherWorkspace = forward ? backwardWorkspace : forwardWorkspace;
+
+        QueueEntry smallest = workspace.queueTop();
+        workspace.pop();
+
+        int vertex = smallest.second;
+
+        if (smallest.first > workspace.distance(vertex))
+        {
+            workspace.counters().countStalePop();
+            continue;
+        }
+
+        workspace.counters().countSettled();
+
+        int begin = forward ? offsets_[vertex] : reverseOffsets_[vertex];
+        int end = forward ? offsets_[vertex + 1] : reverseOffsets_[vertex + 1];
+
+        for (int position = begin; position < end; ++position)
+        {
+            int edge = forward ? position : reverseEdges_[position];
+            int neighbor = forward ? targets_[edge] : sources_[edge];
+            double candidate = smallest.first + weight(edge);
+
+            workspace.counters().countRelaxed();
+
+            if (candidate < workspace.distance(neighbor))
+            {
+                workspace.label(neighbor, candidate, vertex, edge);
+                workspace.push(QueueEntry{candidate, neighbor});
+
+                if (candidate + otherWorkspace.distance(neighbor) < best)
+                {
+                    best = candidate + otherWorkspace.distance(neighbor);
+                    meeting = neighbor;
+                }
+            }
+        }
+    }
+
+    if (meeting < 0)
+    {
+        return Route{};
+    }
+
+    // The backward labels point toward the end vertex, through the edges
+    // that leave each vertex on the way there.
+    std::vector<int> edges = forwardWorkspace.traceEdges(startVertex, meeting);
+
+    for (int vertex = meeting; vertex != endVertex; vertex = backwardWorkspace.predecessor(vertex))
+    {
+        edges.push_back(backwardWorkspace.predecessorEdge(vertex));
+    }
+
+    return makeRoute(startVertex, edges);
+}
+
+
+// Since the heuristic never drops by more than an edge's weight, the first
+// time a vertex leaves the queue its distance is final, so each vertex is
+// expanded at most once, just as in findShortestPath().
+template <typename EdgeWeightFunc, typename Heuristic>
+Route CompactRoadGraph::findShortestPathGuided(
+    int startVertex, int endVertex, EdgeWeightFunc edgeWeightFunc,
+    Heuristic heuristic, QueryWorkspace& workspace) const
+{
+    auto weight = edgeWeights(edgeWeightFunc);
+
+    checkEndpoints(startVertex, endVertex);
+
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    workspace.prepare(vertexCount());
+    workspace.label(startVertex, 0.0, startVertex, -1);
+    workspace.push(QueueEntry{heuristic(startVertex), startVertex});
+
+    while (!workspace.queueEmpty())
+    {
+        int vertex = workspace.queueTop().second;
+        workspace.pop();
+
+        if (workspace.settled(vertex))
+        {
+            workspace.counters().countStalePop();
+            continue;
+        }
+
+        workspace.settle(vertex);
+        workspace.counters().countSettled();
+
+        if (vertex == endVertex)
+        {
+            return makeRoute(startVertex, workspace.traceEdges(startVertex, endVertex));
+        }
+
+        for (int edge = offsets_[vertex]; edge < offsets_[vertex + 1]; ++edge)
+        {
+            int target = targets_[edge];
+            double candidate = workspace.distance(vertex) + weight(edge);
+
+            workspace.counters().countRelaxed();
+
+            if (!workspace.settled(target) && candidate < workspace.distance(target))
+            {
+                double bound = heuristic(target);
+
+                if (bound == infinity)
+                {
+                    continue;
+                }
+
+                workspace.label(target, candidate, vertex, edge);
+                workspace.push(QueueEntry{candidate + bound, target});
+            }
+        }
+    }
+
+    return Route{};
+}
+
+
+
+#endif // COMPACTROADGRAPH_HPP
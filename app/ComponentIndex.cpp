@@ -0,0 +1,31 @@
+// ComponentIndex.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include "ComponentIndex.hpp"
+#include "StrongComponents.hpp"
+#include "TraceRecorder.hpp"
+
+
+ComponentIndex::ComponentIndex(const CompactRoadGraph& graph)
+    : components_(graph.vertexCount())
+{
+    TraceSpan span{"index components"};
+
+    CompactRoadColumns columns = graph.columns();
+
+    int componentCount = findStrongComponents(
+        columns.vertexCount, columns.offsets, columns.targets, components_.data());
+
+    condenseComponents(
+        columns.vertexCount, columns.offsets, columns.targets,
+        components_.data(), componentCount, condensedOffsets_, condensedTargets_);
+
+    hasIncomingEdge_.assign(componentCount, 0);
+
+    for (int target : condensedTargets_)
+    {
+        hasIncomingEdge_[target] = 1;
+    }
+}
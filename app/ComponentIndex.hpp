@@ -0,0 +1,76 @@
+// ComponentIndex.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A ComponentIndex records the strongly connected components of a
+// CompactRoadGraph and the condensation between them, so that a trip whose
+// end vertex can't possibly be reached is turned away in constant time
+// instead of with a search that explores everything reachable from its
+// start vertex.
+//
+// The components are numbered in reverse topological order (see
+// StrongComponents.hpp), so every edge between components leads to a
+// lower-numbered one.  A vertex can therefore never reach a vertex in a
+// higher-numbered component, and mayReach() also knows that a component
+// with no edges leaving it, or none entering it, is cut off from every
+// other.  Whatever those rules can't settle is left to the search.
+//
+// The index only depends on which edges exist, so it stays correct after
+// updateSpeeds().
+
+#ifndef COMPONENTINDEX_HPP
+#define COMPONENTINDEX_HPP
+
+#include <vector>
+#include "CompactRoadGraph.hpp"
+
+
+
+class ComponentIndex
+{
+public:
+    // Finds the strongly connected components of the given graph.
+    explicit ComponentIndex(const CompactRoadGraph& graph);
+
+    // componentCount() returns the number of components.
+    int componentCount() const { return static_cast<int>(condensedOffsets_.size()) - 1; }
+
+    // component() returns the component number of the given vertex.
+    int component(int vertex) const { return components_[vertex]; }
+
+    // The condensation has an edge from component c to every component
+    // that some edge leaving c leads to; the positions of c's edges are
+    // [condensedEdgeBegin(c), condensedEdgeEnd(c)), in increasing order of
+    // target component.
+    int condensedEdgeBegin(int component) const { return condensedOffsets_[component]; }
+    int condensedEdgeEnd(int component) const { return condensedOffsets_[component + 1]; }
+    int condensedEdgeTarget(int position) const { return condensedTargets_[position]; }
+
+    // mayReach() returns false if the end vertex certainly can't be reached
+    // from the start vertex, and true if it can or might be.
+    bool mayReach(int startVertex, int endVertex) const
+    {
+        int startComponent = components_[startVertex];
+        int endComponent = components_[endVertex];
+
+        if (startComponent == endComponent)
+        {
+            return true;
+        }
+
+        return startComponent > endComponent
+            && condensedEdgeBegin(startComponent) != condensedEdgeEnd(startComponent)
+            && hasIncomingEdge_[endComponent];
+    }
+
+private:
+    std::vector<int> components_;
+    std::vector<int> condensedOffsets_;
+    std::vector<int> condensedTargets_;
+    std::vector<char> hasIncomingEdge_;
+};
+
+
+
+#endif // COMPONENTINDEX_HPP
@@ -0,0 +1,677 @@
+// ContractionHierarchy.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include "ContractionHierarchy.hpp"
+#include "TraceRecorder.hpp"
+
+
+namespace
+{
+    typedef QueryWorkspace::QueueEntry QueueEntry;
+
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    // A witness search gives up after settling this many vertices and
+    // assumes that no witness exists, which can only add shortcuts that
+    // weren't strictly needed.  Estimating a vertex's priority uses a
+    // smaller limit, but not so small that missed witnesses inflate its
+    // shortcut count and push it out of its proper place in the order.
+    const int witnessSettleLimit = 500;
+    const int priorityWitnessSettleLimit = 50;
+
+
+    // hops is the number of original edges that an arc stands for.
+    struct OverlayArc
+    {
+        int vertex;
+        int middle;
+        double weight;
+        int hops;
+    };
+
+
+    struct Shortcut
+    {
+        int fromVertex;
+        int toVertex;
+        int middle;
+        double weight;
+        int hops;
+    };
+
+
+    // The overlay is the part of the graph that hasn't been contracted
+    // yet, including the shortcuts added so far, with at most one arc
+    // (the lightest) between any two vertices.
+    struct Overlay
+    {
+        std::vector<std::vector<OverlayArc>> outArcs;
+        std::vector<std::vector<OverlayArc>> inArcs;
+    };
+
+
+    // Adds an arc to the list, or lowers the weight of the arc to the same
+    // vertex if the list already has a heavier one.
+    void addArc(std::vector<OverlayArc>& arcs, const OverlayArc& arc)
+    {
+        for (OverlayArc& existing : arcs)
+        {
+            if (existing.vertex == arc.vertex)
+            {
+                if (arc.weight < existing.weight)
+                {
+                    existing = arc;
+                }
+
+                return;
+            }
+        }
+
+        arcs.push_back(arc);
+    }
+
+
+    // Removes every arc to a blocked vertex from the list in one pass.
+    void removeBlockedArcs(std::vector<OverlayArc>& arcs, const std::vector<char>& blocked)
+    {
+        arcs.erase(
+            std::remove_if(
+                arcs.begin(), arcs.end(),
+                [&blocked](const OverlayArc& arc) { return blocked[arc.vertex] != 0; }),
+            arcs.end());
+    }
+
+
+    // Each worker keeps one WitnessSearch and reuses its QueryWorkspace,
+    // so starting a search costs nothing however large the graph is.
+    class WitnessSearch
+    {
+    public:
+        explicit WitnessSearch(int vertexCount)
+            : vertexCount_{vertexCount}, targets_(vertexCount, 0)
+        {
+        }
+
+        // run() computes distances from the source vertex through the
+        // overlay, never entering the skipped vertex or any vertex that
+        // is blocked.  It stops once every one of the given target arcs'
+        // vertices is settled, once the smallest label exceeds the limit,
+        // or once the settle limit is reached.
+        void run(
+            const Overlay& overlay, const std::vector<char>& blocked,
+            int sourceVertex, int skippedVertex,
+            const std::vector<OverlayArc>& targetArcs, double limit, int settleLimit)
+        {
+            int settled = 0;
+            int targetsLeft = 0;
+
+            for (const OverlayArc& arc : targetArcs)
+            {
+                if (arc.vertex != sourceVertex && !targets_[arc.vertex])
+                {
+                    targets_[arc.vertex] = 1;
+                    ++targetsLeft;
+                }
+            }
+
+            workspace_.prepare(vertexCount_);
+            workspace_.label(sourceVertex, 0.0, sourceVertex, -1);
+            workspace_.push(QueueEntry{0.0, sourceVertex});
+
+            while (!workspace_.queueEmpty() && settled < settleLimit && targetsLeft > 0)
+            {
+                QueueEntry smallest = workspace_.queueTop();
+                workspace_.pop();
+
+                int vertex = smallest.second;
+
+                if (smallest.first > workspace_.distance(vertex))
+                {
+                    continue;
+                }
+
+                if (smallest.first > limit)
+                {
+                    break;
+                }
+
+                ++settled;
+
+                if (targets_[vertex])
+                {
+                    --targetsLeft;
+                }
+
+                for (const OverlayArc& arc : overlay.outArcs[vertex])
+                {
+                    if (arc.vertex == skippedVertex || blocked[arc.vertex])
+                    {
+                        continue;
+                    }
+
+                    double candidate = smallest.first + arc.weight;
+
+                    if (candidate < workspace_.distance(arc.vertex))
+                    {
+                        workspace_.label(arc.vertex, candidate, vertex, -1);
+                        workspace_.push(QueueEntry{candidate, arc.vertex});
+                    }
+                }
+            }
+
+            for (const OverlayArc& arc : targetArcs)
+            {
+                targets_[arc.vertex] = 0;
+            }
+        }
+
+        // distance() returns the distance that the last run() found to the
+        // given vertex, which is infinite if it wasn't reached.
+        double distance(int vertex) const { return workspace_.distance(vertex); }
+
+    private:
+        int vertexCount_;
+        QueryWorkspace workspace_;
+        std::vector<char> targets_;
+    };
+
+
+    // Returns the shortcuts that contracting the given vertex would need:
+    // one for every pair of neighbors u -> v -> w with no witness path
+    // from u to w that is at most as long and avoids v and every blocked
+    // vertex.
+    std::vector<Shortcut> findShortcuts(
+        const Overlay& overlay, const std::vector<char>& blocked,
+        int vertex, int settleLimit, WitnessSearch& search)
+    {
+        std::vector<Shortcut> shortcuts;
+        const std::vector<OverlayArc>& inArcs = overlay.inArcs[vertex];
+        const std::vector<OverlayArc>& outArcs = overlay.outArcs[vertex];
+
+        if (outArcs.empty())
+        {
+            return shortcuts;
+        }
+
+        for (const OverlayArc& in : inArcs)
+        {
+            double limit = 0.0;
+
+            for (const OverlayArc& out : outArcs)
+            {
+                if (out.vertex != in.vertex)
+                {
+                    limit = std::max(limit, in.weight + out.weight);
+                }
+            }
+
+            search.run(overlay, blocked, in.vertex, vertex, outArcs, limit, settleLimit);
+
+            for (const OverlayArc& out : outArcs)
+            {
+                double through = in.weight + out.weight;
+
+                if (out.vertex != in.vertex && search.distance(out.vertex) > through)
+                {
+                    shortcuts.push_back(
+                        Shortcut{in.vertex, out.vertex, vertex, through, in.hops + out.hops});
+                }
+            }
+
+        }
+
+        return shortcuts;
+    }
+}
+
+
+ContractionHierarchy::ContractionHierarchy(
+    const CompactRoadGraph& graph, TripMetric metric, WorkStealingPool& pool)
+    : graph_{graph}, rank_(graph.vertexCount(), -1), shortcutCount_{0}
+{
+    TraceSpan span{"contract hierarchy"};
+
+    int vertexCount = graph.vertexCount();
+    const double* weights = graph.weightColumn(metric);
+
+    Overlay overlay;
+    overlay.outArcs.resize(vertexCount);
+    overlay.inArcs.resize(vertexCount);
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        for (int edge = graph.edgeBegin(vertex); edge < graph.edgeEnd(vertex); ++edge)
+        {
+            int target = graph.edgeTarget(edge);
+
+            if (target != vertex)
+            {
+                addArc(overlay.outArcs[vertex], OverlayArc{target, -1 - edge, weights[edge], 1});
+                addArc(overlay.inArcs[target], OverlayArc{vertex, -1 - edge, weights[edge], 1});
+            }
+        }
+    }
+
+    std::vector<WitnessSearch> searches(pool.threadCount(), WitnessSearch{vertexCount});
+    std::vector<char> blocked(vertexCount, 0);
+    std::vector<char> dirty(vertexCount, 0);
+    std::vector<int> touchedRound(vertexCount, -1);
+    std::vector<double> priorities(vertexCount, 0.0);
+    std::vector<int> levels(vertexCount, 0);
+    std::vector<std::vector<OverlayArc>> upArcs(vertexCount);
+    std::vector<std::vector<OverlayArc>> downArcs(vertexCount);
+
+    std::vector<int> remaining(vertexCount);
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        remaining[vertex] = vertex;
+    }
+
+    auto estimatePriorities = [&](const std::vector<int>& vertices)
+    {
+        pool.parallelFor(
+            static_cast<int>(vertices.size()),
+            [&](int index, unsigned worker)
+            {
+                int vertex = vertices[index];
+                std::vector<Shortcut> shortcuts = findShortcuts(
+                    overlay, blocked, vertex, priorityWitnessSettleLimit, searches[worker]);
+
+                int addedHops = 0;
+                int removedHops = 0;
+
+                for (const Shortcut& shortcut : shortcuts)
+                {
+                    addedHops += shortcut.hops;
+                }
+
+                for (const std::vector<OverlayArc>* arcs :
+                     {&overlay.outArcs[vertex], &overlay.inArcs[vertex]})
+                {
+                    for (const OverlayArc& arc : *arcs)
+                    {
+                        removedHops += arc.hops;
+                    }
+                }
+
+                int removed = static_cast<int>(
+                    overlay.inArcs[vertex].size() + overlay.outArcs[vertex].size());
+
+                priorities[vertex] = levels[vertex];
+
+                if (removed > 0)
+                {
+                    priorities[vertex] +=
+                        4.0 * shortcuts.size() / removed + 2.0 * addedHops / removedHops;
+                }
+
+                dirty[vertex] = 0;
+            });
+    };
+
+    auto lessImportantThanNeighbors = [&](int vertex)
+    {
+        auto lessImportant = [&](int a, int b)
+        {
+            return std::make_pair(priorities[a], a) < std::make_pair(priorities[b], b);
+        };
+
+        for (const std::vector<OverlayArc>* arcs :
+             {&overlay.outArcs[vertex], &overlay.inArcs[vertex]})
+        {
+            for (const OverlayArc& arc : *arcs)
+            {
+                if (!lessImportant(vertex, arc.vertex))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    };
+
+    estimatePriorities(remaining);
+
+    int nextRank = 0;
+
+    for (int round = 0; !remaining.empty(); ++round)
+    {
+        // A vertex whose neighborhood changed is only re-estimated once
+        // its stale priority makes it a candidate for contraction.
+        // Contracting a neighbor usually makes a vertex more important, so
+        // most stale vertices aren't re-estimated round after round, which
+        // matters most at the top of the hierarchy, where every remaining
+        // vertex is a neighbor of nearly every other.
+        std::vector<int> candidates;
+
+        for (int vertex : remaining)
+        {
+            if (dirty[vertex] && lessImportantThanNeighbors(vertex))
+            {
+                candidates.push_back(vertex);
+            }
+        }
+
+        estimatePriorities(candidates);
+
+        // Contract every vertex with an up-to-date priority that is less
+        // important than all of its neighbors; no two such vertices are
+        // adjacent.  The least important vertex of all is either
+        // contracted or re-estimated, so every round makes progress.
+        std::vector<int> selected;
+
+        for (int vertex : remaining)
+        {
+            if (!dirty[vertex] && lessImportantThanNeighbors(vertex))
+            {
+                selected.push_back(vertex);
+            }
+        }
+
+        for (int vertex : selected)
+        {
+            blocked[vertex] = 1;
+        }
+
+        // The witness searches of this round avoid every selected vertex,
+        // since they're all removed at once.
+        std::vector<std::vector<Shortcut>> shortcuts(selected.size());
+
+        pool.parallelFor(
+            static_cast<int>(selected.size()),
+            [&](int index, unsigned worker)
+            {
+                shortcuts[index] = findShortcuts(
+                    overlay, blocked, selected[index], witnessSettleLimit, searches[worker]);
+            });
+
+        // Every neighbor of a selected vertex loses its arcs to all of the
+        // round's selected vertices at once, with one pass over each of its
+        // lists, however many of them it was adjacent to.
+        std::vector<int> touched;
+
+        for (int vertex : selected)
+        {
+            rank_[vertex] = nextRank++;
+            upArcs[vertex] = std::move(overlay.outArcs[vertex]);
+            downArcs[vertex] = std::move(overlay.inArcs[vertex]);
+
+            for (const std::vector<OverlayArc>* arcs : {&upArcs[vertex], &downArcs[vertex]})
+            {
+                for (const OverlayArc& arc : *arcs)
+                {
+                    dirty[arc.vertex] = 1;
+
+                    if (touchedRound[arc.vertex] != round)
+                    {
+                        touchedRound[arc.vertex] = round;
+                        touched.push_back(arc.vertex);
+                    }
+
+                    levels[arc.vertex] = std::max(levels[arc.vertex], levels[vertex] + 1);
+                }
+            }
+        }
+
+        pool.parallelFor(
+            static_cast<int>(touched.size()),
+            [&](int index, unsigned)
+            {
+                removeBlockedArcs(overlay.outArcs[touched[index]], blocked);
+                removeBlockedArcs(overlay.inArcs[touched[index]], blocked);
+            });
+
+        for (const std::vector<Shortcut>& vertexShortcuts : shortcuts)
+        {
+            for (const Shortcut& shortcut : vertexShortcuts)
+            {
+                addArc(
+                    overlay.outArcs[shortcut.fromVertex],
+                    OverlayArc{shortcut.toVertex, shortcut.middle, shortcut.weight, shortcut.hops});
+                addArc(
+                    overlay.inArcs[shortcut.toVertex],
+                    OverlayArc{shortcut.fromVertex, shortcut.middle, shortcut.weight, shortcut.hops});
+            }
+        }
+
+        remaining.erase(
+            std::remove_if(
+                remaining.begin(), remaining.end(),
+                [&](int vertex) { return blocked[vertex] != 0; }),
+            remaining.end());
+    }
+
+    // Lay the arcs of every vertex out contiguously for the queries.
+    upOffsets_.assign(1, 0);
+    downOffsets_.assign(1, 0);
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        for (const OverlayArc& arc : upArcs[vertex])
+        {
+            upArcs_.push_back(Arc{arc.vertex, arc.middle, arc.weight});
+            shortcutCount_ += arc.middle >= 0;
+        }
+
+        for (const OverlayArc& arc : downArcs[vertex])
+        {
+            downArcs_.push_back(Arc{arc.vertex, arc.middle, arc.weight});
+            shortcutCount_ += arc.middle >= 0;
+        }
+
+        upOffsets_.push_back(static_cast<int>(upArcs_.size()));
+        downOffsets_.push_back(static_cast<int>(downArcs_.size()));
+    }
+}
+
+
+Route ContractionHierarchy::findShortestPath(int startVertex, int endVertex) const
+{
+    QueryWorkspace forwardWorkspace;
+    QueryWorkspace backwardWorkspace;
+
+    return findShortestPath(startVertex, endVertex, forwardWorkspace, backwardWorkspace);
+}
+
+
+// The query alternates between the two upward searches like
+// CompactRoadGraph::findShortestPathBidirectional() does, but it can't
+// stop when the frontiers first meet: the best meeting vertex is usually
+// high in the hierarchy, so each side runs until its smallest label alone
+// reaches the best connection found so far.  The predecessor edge of each
+// label is the index of the arc it was reached through.
+Route ContractionHierarchy::findShortestPath(
+    int startVertex, int endVertex,
+    QueryWorkspace& forwardWorkspace, QueryWorkspace& backwardWorkspace) const
+{
+    if (startVertex < 0 || startVertex >= vertexCount()
+        || endVertex < 0 || endVertex >= vertexCount())
+    {
+        throw DigraphException("Vertex does not exist.");
+    }
+
+    forwardWorkspace.prepare(vertexCount());
+    backwardWorkspace.prepare(vertexCount());
+    forwardWorkspace.label(startVertex, 0.0, startVertex, -1);
+    backwardWorkspace.label(endVertex, 0.0, endVertex, -1);
+    forwardWorkspace.push(QueueEntry{0.0, startVertex});
+    backwardWorkspace.push(QueueEntry{0.0, endVertex});
+
+    double best = startVertex == endVertex ? 0.0 : infinity;
+    int meeting = startVertex == endVertex ? startVertex : -1;
+
+    for (;;)
+    {
+        bool forwardLive =
+            !forwardWorkspace.queueEmpty() && forwardWorkspace.queueTop().first < best;
+        bool backwardLive =
+            !backwardWorkspace.queueEmpty() && backwardWorkspace.queueTop().first < best;
+
+        if (!forwardLive && !backwardLive)
+        {
+            break;
+        }
+
+        bool forward = forwardLive
+            && (!backwardLive
+                || forwardWorkspace.queueTop().first <= backwardWorkspace.queueTop().first);
+
+        QueryWorkspace& workspace = forward ? forwardWorkspace : backwardWorkspace;
+        QueryWorkspace& otherWorkspace = forward ? backwardWorkspace : forwardWorkspace;
+        const std::vector<int>& offsets = forward ? upOffsets_ : downOffsets_;
+        const std::vector<Arc>& arcs = forward ? upArcs_ : downArcs_;
+        const std::vector<int>& stallOffsets = forward ? downOffsets_ : upOffsets_;
+        const std::vector<Arc>& stallArcs = forward ? downArcs_ : upArcs_;
+
+        QueueEntry smallest = workspace.queueTop();
+        workspace.pop();
+
+        int vertex = smallest.second;
+
+        if (smallest.first > workspace.distance(vertex))
+        {
+            workspace.counters().countStalePop();
+            continue;
+        }
+
+        workspace.counters().countSettled();
+
+        // Stall on demand: if a higher-ranked vertex that this search has
+        // already reached offers a shorter way into this one, then this
+        // label isn't a shortest distance, and nothing relaxed from it can
+        // lie on the shortest path, so its arcs are skipped.
+        bool stalled = false;
+
+        for (int arc = stallOffsets[vertex]; arc < stallOffsets[vertex + 1] && !stalled; ++arc)
+        {
+            stalled = workspace.distance(stallArcs[arc].vertex) + stallArcs[arc].weight
+                < smallest.first;
+        }
+
+        if (stalled)
+        {
+            continue;
+        }
+
+        for (int arc = offsets[vertex]; arc < offsets[vertex + 1]; ++arc)
+        {
+            int neighbor = arcs[arc].vertex;
+            double candidate = smallest.first + arcs[arc].weight;
+
+            workspace.counters().countRelaxed();
+
+            if (candidate < workspace.distance(neighbor))
+            {
+                workspace.label(neighbor, candidate, vertex, arc);
+                workspace.push(QueueEntry{candidate, neighbor});
+
+                if (candidate + otherWorkspace.distance(neighbor) < best)
+                {
+                    best = candidate + otherWorkspace.distance(neighbor);
+                    meeting = neighbor;
+                }
+            }
+        }
+    }
+
+    if (meeting < 0)
+    {
+        return Route{};
+    }
+
+    // Collect the arcs from the start vertex up to the meeting vertex and
+    // from there down to the end vertex, then unpack them in order.
+    std::vector<int> upward;
+
+    for (int vertex = meeting; vertex != startVertex; vertex = forwardWorkspace.predecessor(vertex))
+    {
+        upward.push_back(vertex);
+    }
+
+    std::vector<int> edges;
+
+    for (auto vertex = upward.rbegin(); vertex != upward.rend(); ++vertex)
+    {
+        unpack(
+            forwardWorkspace.predecessor(*vertex), *vertex,
+            upArcs_[forwardWorkspace.predecessorEdge(*vertex)].middle, edges);
+    }
+
+    for (int vertex = meeting; vertex != endVertex; vertex = backwardWorkspace.predecessor(vertex))
+    {
+        unpack(
+            vertex, backwardWorkspace.predecessor(vertex),
+            downArcs_[backwardWorkspace.predecessorEdge(vertex)].middle, edges);
+    }
+
+    return graph_.makeRoute(startVertex, edges);
+}
+
+
+int ContractionHierarchy::findMiddle(int fromVertex, int toVertex) const
+{
+    // An arc is stored with its lower-ranked endpoint: as an up arc of its
+    // source, or as a down arc of its target.
+    if (rank_[fromVertex] < rank_[toVertex])
+    {
+        for (int arc = upOffsets_[fromVertex]; arc < upOffsets_[fromVertex + 1]; ++arc)
+        {
+            if (upArcs_[arc].vertex == toVertex)
+            {
+                return upArcs_[arc].middle;
+            }
+        }
+    }
+    else
+    {
+        for (int arc = downOffsets_[toVertex]; arc < downOffsets_[toVertex + 1]; ++arc)
+        {
+            if (downArcs_[arc].vertex == fromVertex)
+            {
+                return downArcs_[arc].middle;
+            }
+        }
+    }
+
+    throw DigraphException("Shortcut refers to a missing arc.");
+}
+
+
+void ContractionHierarchy::unpack(
+    int fromVertex, int toVertex, int middle, std::vector<int>& edges) const
+{
+    // Shortcuts nest as deep as the hierarchy, so unpack them with an
+    // explicit stack of arcs still to be expanded, leftmost on top.
+    struct PendingArc
+    {
+        int fromVertex;
+        int toVertex;
+        int middle;
+    };
+
+    std::vector<PendingArc> pending{PendingArc{fromVertex, toVertex, middle}};
+
+    while (!pending.empty())
+    {
+        PendingArc arc = pending.back();
+        pending.pop_back();
+
+        if (arc.middle < 0)
+        {
+            edges.push_back(-1 - arc.middle);
+            continue;
+        }
+
+        pending.push_back(
+            PendingArc{arc.middle, arc.toVertex, findMiddle(arc.middle, arc.toVertex)});
+        pending.push_back(
+            PendingArc{arc.fromVertex, arc.middle, findMiddle(arc.fromVertex, arc.middle)});
+    }
+}
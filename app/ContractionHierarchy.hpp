@@ -0,0 +1,120 @@
+// ContractionHierarchy.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A ContractionHierarchy answers point-to-point queries over one
+// TripMetric of a CompactRoadGraph far faster than a Dijkstra search can,
+// by preprocessing the graph once.
+//
+// Preprocessing removes ("contracts") the vertices one at a time, least
+// important first, where importance grows with how deep in the hierarchy
+// a vertex sits, how many shortcuts its removal would need for each arc it
+// removes, and how many original edges those shortcuts would stand for
+// next to the ones its arcs stand for.  (Comparing ratios rather than the
+// plain difference in arcs spreads the contractions evenly over the map,
+// which keeps later shortcuts short.)  Removing vertex v adds a
+// shortcut edge u -> w for each pair of neighbors u -> v -> w whose
+// shortest connection runs through v; a bounded "witness" search decides
+// whether some other path is at least as short.  Each round contracts a
+// set of vertices that are not adjacent to each other, with the witness
+// searches of the round spread across a WorkStealingPool.  A vertex's
+// importance is re-estimated lazily, only once a neighbor has been
+// contracted and the vertex has become a candidate for the next round.
+//
+// A query then runs a bidirectional search that only ever climbs the
+// hierarchy: forward from the start vertex along edges to vertices that
+// were contracted later, and backward from the end vertex the same way.
+// Each search "stalls" a vertex whose label a higher-ranked vertex can
+// already beat, without relaxing its edges, so both settle only a few
+// hundred vertices even on a large map.
+// The shortcuts on the path they find are unpacked recursively into the
+// original edges, so a route is a Route of the graph, exactly like the ones
+// the other searches return.
+//
+// The hierarchy copies the weights it needs, so it keeps answering with the
+// weights the graph had when it was built; rebuild it after updateSpeeds().
+// The Routes it returns are read out of the graph, which must outlive it.
+
+#ifndef CONTRACTIONHIERARCHY_HPP
+#define CONTRACTIONHIERARCHY_HPP
+
+#include <vector>
+#include "CompactRoadGraph.hpp"
+#include "QueryWorkspace.hpp"
+#include "TripMetric.hpp"
+#include "WorkStealingPool.hpp"
+
+
+
+class ContractionHierarchy
+{
+public:
+    // Builds the hierarchy for the given TripMetric of the given graph,
+    // running the witness searches on the given pool.
+    ContractionHierarchy(
+        const CompactRoadGraph& graph, TripMetric metric, WorkStealingPool& pool);
+
+    // vertexCount() returns the number of vertices in the hierarchy.
+    int vertexCount() const { return static_cast<int>(rank_.size()); }
+
+    // shortcutCount() returns the number of shortcut edges that
+    // preprocessing added.
+    int shortcutCount() const { return shortcutCount_; }
+
+    // rank() returns the position of the given vertex in the contraction
+    // order; vertices with higher ranks are more important.
+    int rank(int vertex) const { return rank_[vertex]; }
+
+    // findShortestPath() returns the Route along a shortest path from the
+    // start vertex to the end vertex, or an empty Route if the end vertex
+    // can't be reached.  If either vertex does not exist, a
+    // DigraphException is thrown instead.
+    Route findShortestPath(int startVertex, int endVertex) const;
+
+    // This overload of findShortestPath() keeps the labels of the upward
+    // searches in the given workspaces.
+    Route findShortestPath(
+        int startVertex, int endVertex,
+        QueryWorkspace& forwardWorkspace, QueryWorkspace& backwardWorkspace) const;
+
+private:
+    // An Arc is an edge of the hierarchy, stored with the lower-ranked of
+    // its two endpoints; vertex is the other endpoint.  middle is the
+    // vertex whose contraction added the arc as a shortcut, or, if the arc
+    // is an edge of the original graph, -1 - e for that edge's index e.
+    struct Arc
+    {
+        int vertex;
+        int middle;
+        double weight;
+    };
+
+    // findMiddle() returns the middle vertex of the arc from the given
+    // "from" vertex to the given "to" vertex.
+    int findMiddle(int fromVertex, int toVertex) const;
+
+    // unpack() appends to edges the indices of the original edges that an
+    // arc stands for, in order from fromVertex to toVertex.
+    void unpack(int fromVertex, int toVertex, int middle, std::vector<int>& edges) const;
+
+private:
+    const CompactRoadGraph& graph_;
+    std::vector<int> rank_;
+
+    // The arcs leaving vertex v toward higher-ranked vertices are
+    // upArcs_[upOffsets_[v]] through upArcs_[upOffsets_[v + 1] - 1].  The
+    // arcs entering v from higher-ranked vertices are stored the same way
+    // in downOffsets_ and downArcs_, with vertex naming their source; the
+    // backward search walks them in reverse.
+    std::vector<int> upOffsets_;
+    std::vector<Arc> upArcs_;
+    std::vector<int> downOffsets_;
+    std::vector<Arc> downArcs_;
+
+    int shortcutCount_;
+};
+
+
+
+#endif // CONTRACTIONHIERARCHY_HPP
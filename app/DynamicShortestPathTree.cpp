@@ -0,0 +1,181 @@
+// DynamicShortestPathTree.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <limits>
+#include "DynamicShortestPathTree.hpp"
+#include "TraceRecorder.hpp"
+
+
+DynamicShortestPathTree::DynamicShortestPathTree(
+    const CompactRoadGraph& graph, int startVertex, TripMetric metric)
+    : graph_{graph}, startVertex_{startVertex}, metric_{metric},
+      distances_(graph.vertexCount(), std::numeric_limits<double>::infinity()),
+      predecessorEdges_(graph.vertexCount(), -1)
+{
+    TraceSpan span{"search tree"};
+
+    if (!graph_.hasVertex(startVertex))
+    {
+        throw DigraphException("Start vertex does not exist.");
+    }
+
+    SearchQueue queue;
+    distances_[startVertex] = 0.0;
+    queue.push(QueueEntry{0.0, startVertex});
+    counters_.countPush();
+    settle(queue);
+}
+
+
+Route DynamicShortestPathTree::route(int endVertex) const
+{
+    if (distances_[endVertex] == std::numeric_limits<double>::infinity())
+    {
+        return Route{};
+    }
+
+    std::vector<int> edges;
+
+    for (int vertex = endVertex; vertex != startVertex_; )
+    {
+        edges.push_back(predecessorEdges_[vertex]);
+        vertex = graph_.edgeSource(edges.back());
+    }
+
+    std::reverse(edges.begin(), edges.end());
+    return graph_.makeRoute(startVertex_, edges);
+}
+
+
+void DynamicShortestPathTree::repair(const std::vector<int>& changedEdges)
+{
+    TraceSpan span{"repair tree"};
+
+    counters_ = SearchCounters{};
+
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double* weights = graph_.weightColumn(metric_);
+
+    // First, find the subtrees hanging below tree edges whose weight went
+    // up.  A vertex's children are the targets of its outgoing edges that
+    // are also their predecessor edges.
+    std::vector<char> affected(graph_.vertexCount(), false);
+    std::vector<int> subtree;
+
+    for (int edge : changedEdges)
+    {
+        int target = graph_.edgeTarget(edge);
+
+        if (predecessorEdges_[target] != edge || affected[target]
+            || distances_[graph_.edgeSource(edge)] + weights[edge] <= distances_[target])
+        {
+            continue;
+        }
+
+        std::size_t first = subtree.size();
+        subtree.push_back(target);
+        affected[target] = true;
+
+        for (std::size_t i = first; i < subtree.size(); ++i)
+        {
+            int vertex = subtree[i];
+
+            for (int out = graph_.edgeBegin(vertex); out < graph_.edgeEnd(vertex); ++out)
+            {
+                int child = graph_.edgeTarget(out);
+
+                if (predecessorEdges_[child] == out && !affected[child])
+                {
+                    affected[child] = true;
+                    subtree.push_back(child);
+                }
+            }
+        }
+    }
+
+    for (int vertex : subtree)
+    {
+        distances_[vertex] = infinity;
+        predecessorEdges_[vertex] = -1;
+    }
+
+    // Every vertex in those subtrees is relabeled from its incoming edges
+    // that come from outside of them, whose labels are still valid.
+    SearchQueue queue;
+
+    for (int vertex : subtree)
+    {
+        for (int position = graph_.reverseEdgeBegin(vertex);
+             position < graph_.reverseEdgeEnd(vertex); ++position)
+        {
+            int edge = graph_.reverseEdge(position);
+            int source = graph_.edgeSource(edge);
+
+            if (!affected[source] && distances_[source] + weights[edge] < distances_[vertex])
+            {
+                lower(vertex, distances_[source] + weights[edge], edge, queue);
+            }
+        }
+    }
+
+    // Edges that got faster may now offer a shorter path to their target.
+    for (int edge : changedEdges)
+    {
+        int source = graph_.edgeSource(edge);
+        int target = graph_.edgeTarget(edge);
+
+        if (!affected[source] && distances_[source] + weights[edge] < distances_[target])
+        {
+            lower(target, distances_[source] + weights[edge], edge, queue);
+        }
+    }
+
+    settle(queue);
+}
+
+
+void DynamicShortestPathTree::lower(int vertex, double distance, int edge, SearchQueue& queue)
+{
+    distances_[vertex] = distance;
+    predecessorEdges_[vertex] = edge;
+    queue.push(QueueEntry{distance, vertex});
+    counters_.countPush();
+}
+
+
+void DynamicShortestPathTree::settle(SearchQueue& queue)
+{
+    const double* weights = graph_.weightColumn(metric_);
+
+    while (!queue.empty())
+    {
+        QueueEntry smallest = queue.top();
+        queue.pop();
+
+        int vertex = smallest.second;
+
+        if (smallest.first > distances_[vertex])
+        {
+            counters_.countStalePop();
+            continue;
+        }
+
+        counters_.countSettled();
+
+        for (int edge = graph_.edgeBegin(vertex); edge < graph_.edgeEnd(vertex); ++edge)
+        {
+            int target = graph_.edgeTarget(edge);
+            double candidate = smallest.first + weights[edge];
+
+            counters_.countRelaxed();
+
+            if (candidate < distances_[target])
+            {
+                lower(target, candidate, edge, queue);
+            }
+        }
+    }
+}
@@ -0,0 +1,80 @@
+// DynamicShortestPathTree.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A DynamicShortestPathTree is a shortest path tree grown from one start
+// vertex of a CompactRoadGraph for one TripMetric, which can be kept up to
+// date as the graph's speeds change without being recomputed from scratch.
+//
+// After a batch of speed updates, repair() is given the indices of the
+// edges that changed.  A tree edge that got slower cuts off the subtree
+// below it; only the vertices in those subtrees are reset and relabeled
+// from their neighbors outside the subtree.  An edge that got faster seeds
+// its target if it now offers a shorter path.  A Dijkstra pass from these
+// seeds then settles exactly the part of the tree whose distances changed.
+
+#ifndef DYNAMICSHORTESTPATHTREE_HPP
+#define DYNAMICSHORTESTPATHTREE_HPP
+
+#include <queue>
+#include <utility>
+#include <vector>
+#include "CompactRoadGraph.hpp"
+#include "SearchCounters.hpp"
+#include "TripMetric.hpp"
+
+
+
+class DynamicShortestPathTree
+{
+public:
+    // Grows a shortest path tree from the given start vertex, weighing
+    // edges by the given TripMetric.  The graph must outlive the tree.  If
+    // the start vertex does not exist, a DigraphException is thrown.
+    DynamicShortestPathTree(const CompactRoadGraph& graph, int startVertex, TripMetric metric);
+
+    int startVertex() const { return startVertex_; }
+    TripMetric metric() const { return metric_; }
+
+    // distance() returns the length of the shortest path to the given
+    // vertex, or infinity if it can't be reached.
+    double distance(int vertex) const { return distances_[vertex]; }
+
+    // route() returns the Route from the start vertex to the given end
+    // vertex, or an empty Route if the end vertex can't be reached.
+    Route route(int endVertex) const;
+
+    // repair() brings the tree up to date after the weights of the edges
+    // with the given edge indices have changed in the graph.
+    void repair(const std::vector<int>& changedEdges);
+
+    // counters() returns the SearchCounters of the work done by the
+    // constructor, or by the last repair() once there has been one.
+    const SearchCounters& counters() const { return counters_; }
+
+private:
+    typedef std::pair<double, int> QueueEntry;
+
+    typedef std::priority_queue<
+        QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> SearchQueue;
+
+    // lower() gives the vertex a shorter distance through the given edge
+    // and queues it.
+    void lower(int vertex, double distance, int edge, SearchQueue& queue);
+
+    // settle() runs Dijkstra's algorithm until the queue is empty.
+    void settle(SearchQueue& queue);
+
+private:
+    const CompactRoadGraph& graph_;
+    int startVertex_;
+    TripMetric metric_;
+    std::vector<double> distances_;
+    std::vector<int> predecessorEdges_;
+    SearchCounters counters_;
+};
+
+
+
+#endif // DYNAMICSHORTESTPATHTREE_HPP
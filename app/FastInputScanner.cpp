@@ -0,0 +1,275 @@
+// FastInputScanner.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include "FastInputScanner.hpp"
+
+
+namespace
+{
+    bool isSpace(char c)
+    {
+        return std::isspace(static_cast<unsigned char>(c)) != 0;
+    }
+
+
+    bool isDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+
+    // Powers of ten that are exactly representable as doubles.
+    const double exactPowersOfTen[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+}
+
+
+FastInputScanner::FastInputScanner(const char* begin, const char* end)
+    : cursor_{begin}, end_{end}, field_{begin}, lineEnd_{begin}, lineBegin_{begin}
+{
+}
+
+
+bool FastInputScanner::nextLine()
+{
+    while (cursor_ != end_)
+    {
+        const char* lineBegin = cursor_;
+        const char* newline = cursor_;
+
+        while (newline != end_ && *newline != '\n')
+        {
+            ++newline;
+        }
+
+        cursor_ = newline == end_ ? end_ : newline + 1;
+
+        const char* lineEnd = newline;
+
+        while (lineEnd != lineBegin && isSpace(lineEnd[-1]))
+        {
+            --lineEnd;
+        }
+
+        if (lineEnd != lineBegin && *lineBegin != '#')
+        {
+            lineBegin_ = lineBegin;
+            field_ = lineBegin;
+            lineEnd_ = lineEnd;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+std::string FastInputScanner::lineText() const
+{
+    return std::string(lineBegin_, lineEnd_);
+}
+
+
+std::string_view FastInputScanner::lineView() const
+{
+    return std::string_view{lineBegin_, static_cast<std::size_t>(lineEnd_ - lineBegin_)};
+}
+
+
+// When the digits fit in 53 bits and the power of ten is exact, a single
+// multiplication or division gives the correctly rounded result (Clinger's
+// fast path); anything else is handed to std::from_chars.
+bool FastInputScanner::parseDouble(const char* begin, const char* end, double& value)
+{
+    const char* p = begin;
+    bool negative = false;
+
+    if (p != end && (*p == '-' || *p == '+'))
+    {
+        negative = *p == '-';
+        ++p;
+    }
+
+    std::uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+
+    for (; p != end && isDigit(*p); ++p)
+    {
+        anyDigits = true;
+
+        if (mantissa != 0 || *p != '0')
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            ++digits;
+        }
+    }
+
+    if (p != end && *p == '.')
+    {
+        for (++p; p != end && isDigit(*p); ++p)
+        {
+            anyDigits = true;
+
+            if (mantissa != 0 || *p != '0')
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                ++digits;
+            }
+
+            --exponent;
+        }
+    }
+
+    bool fastPath = anyDigits && p == end && digits <= 15
+        && exponent >= -22 && exponent <= 22;
+
+    if (fastPath)
+    {
+        value = static_cast<double>(mantissa);
+        value = exponent < 0
+            ? value / exactPowersOfTen[-exponent]
+            : value * exactPowersOfTen[exponent];
+        value = negative ? -value : value;
+        return true;
+    }
+
+    const char* first = begin != end && *begin == '+' ? begin + 1 : begin;
+    std::from_chars_result result = std::from_chars(first, end, value);
+    return result.ec == std::errc{} && result.ptr == end;
+}
+
+
+int FastInputScanner::readInt()
+{
+    const char* begin = nextField();
+    const char* end = field_;
+    const char* p = begin;
+    bool negative = false;
+
+    if (*p == '-' || *p == '+')
+    {
+        negative = *p == '-';
+        ++p;
+    }
+
+    if (p == end)
+    {
+        throw InputFormatException("Expected an integer but found " + std::string(begin, end));
+    }
+
+    long long value = 0;
+
+    for (; p != end; ++p)
+    {
+        if (!isDigit(*p) || value > 2147483648LL)
+        {
+            throw InputFormatException("Expected an integer but found " + std::string(begin, end));
+        }
+
+        value = value * 10 + (*p - '0');
+    }
+
+    value = negative ? -value : value;
+
+    if (value < -2147483648LL || value > 2147483647LL)
+    {
+        throw InputFormatException("Integer out of range: " + std::string(begin, end));
+    }
+
+    return static_cast<int>(value);
+}
+
+
+double FastInputScanner::readDouble()
+{
+    const char* begin = nextField();
+    double value;
+
+    if (!parseDouble(begin, field_, value))
+    {
+        throw InputFormatException("Expected a number but found " + std::string(begin, field_));
+    }
+
+    return value;
+}
+
+
+void FastInputScanner::readWord(const char*& wordBegin, const char*& wordEnd)
+{
+    wordBegin = nextField();
+    wordEnd = field_;
+}
+
+
+void FastInputScanner::requireLineEnd() const
+{
+    if (field_ != lineEnd_)
+    {
+        throw InputFormatException("Unexpected field on line: " + lineText());
+    }
+}
+
+
+std::string FastInputScanner::readLine()
+{
+    requireLine();
+    return lineText();
+}
+
+
+std::string_view FastInputScanner::readLineView()
+{
+    requireLine();
+    return lineView();
+}
+
+
+int FastInputScanner::readIntLine()
+{
+    requireLine();
+    return readInt();
+}
+
+
+void FastInputScanner::requireLine()
+{
+    if (!nextLine())
+    {
+        throw InputFormatException("Unexpected end of input");
+    }
+}
+
+
+// nextField() skips to the next field of the current line, leaves field_
+// just past its end, and returns where it begins.
+const char* FastInputScanner::nextField()
+{
+    while (field_ != lineEnd_ && isSpace(*field_))
+    {
+        ++field_;
+    }
+
+    if (field_ == lineEnd_)
+    {
+        throw InputFormatException("Missing field on line: " + lineText());
+    }
+
+    const char* begin = field_;
+
+    while (field_ != lineEnd_ && !isSpace(*field_))
+    {
+        ++field_;
+    }
+
+    return begin;
+}
@@ -0,0 +1,93 @@
+// FastInputScanner.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A FastInputScanner reads the same line-oriented input as an InputReader,
+// but scans a block of memory (such as a MappedFile) in place instead of
+// pulling lines out of an istream.  It skips the same non-meaningful lines
+// that InputReader does -- blank lines, lines containing only spaces, and
+// lines that begin with a '#' character -- and parses the fields within a
+// line by hand, without building a std::string or std::istringstream.
+
+#ifndef FASTINPUTSCANNER_HPP
+#define FASTINPUTSCANNER_HPP
+
+#include <string>
+#include <string_view>
+
+
+
+// An InputFormatException is thrown by a FastInputScanner when the input
+// runs out early or a field isn't the kind of value that was expected.
+
+class InputFormatException
+{
+public:
+    InputFormatException(const std::string& reason): reason_{reason} { }
+
+    std::string reason() const { return reason_; }
+
+private:
+    std::string reason_;
+};
+
+
+
+class FastInputScanner
+{
+public:
+    // Initializes a FastInputScanner that reads the characters in
+    // [begin, end), which must stay valid while it's in use.
+    FastInputScanner(const char* begin, const char* end);
+
+    // nextLine() moves to the next meaningful line of input and returns
+    // true, or returns false if there are no more meaningful lines.
+    bool nextLine();
+
+    // lineText() returns the current line, without trailing whitespace.
+    // lineView() returns the same characters as a view into the scanned
+    // memory, without copying them.
+    std::string lineText() const;
+    std::string_view lineView() const;
+
+    // readInt(), readDouble() and readWord() parse the next whitespace-
+    // separated field of the current line.  If the line has no more
+    // fields, or the field isn't a valid value, an InputFormatException
+    // is thrown.  readWord() returns the field's characters through the
+    // given pointers.
+    int readInt();
+    double readDouble();
+    void readWord(const char*& wordBegin, const char*& wordEnd);
+
+    // parseDouble() parses all of [begin, end) as a decimal number into
+    // the given double, returning false if it isn't one.  The result is
+    // correctly rounded, exactly as std::istream would read it.
+    static bool parseDouble(const char* begin, const char* end, double& value);
+
+    // requireLineEnd() throws an InputFormatException if the current line
+    // has any fields left.
+    void requireLineEnd() const;
+
+    // readLine() and readIntLine() move to the next meaningful line like
+    // InputReader's functions of the same names, but throw an
+    // InputFormatException if the input has run out.
+    std::string readLine();
+    std::string_view readLineView();
+    int readIntLine();
+
+private:
+    void requireLine();
+    const char* nextField();
+
+private:
+    const char* cursor_;
+    const char* end_;
+    const char* field_;
+    const char* lineEnd_;
+    const char* lineBegin_;
+};
+
+
+
+#endif // FASTINPUTSCANNER_HPP
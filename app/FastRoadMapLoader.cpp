@@ -0,0 +1,108 @@
+// FastRoadMapLoader.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <string>
+#include <utility>
+#include "FastRoadMapLoader.hpp"
+#include "TraceRecorder.hpp"
+
+
+namespace
+{
+    void checkCount(int count, const char* what)
+    {
+        if (count < 0)
+        {
+            throw InputFormatException(std::string{"Negative number of "} + what);
+        }
+    }
+}
+
+
+CompactRoadGraph FastRoadMapLoader::readRoadMap(FastInputScanner& in)
+{
+    TraceSpan span{"read road map"};
+
+    int numberOfLocations = in.readIntLine();
+    checkCount(numberOfLocations, "locations");
+
+    // The names are copied straight out of the scanned memory into one
+    // block of characters.
+    NameTable names;
+    names.reserve(numberOfLocations, 0);
+
+    for (int i = 0; i < numberOfLocations; ++i)
+    {
+        names.add(in.readLineView());
+    }
+
+    int numberOfRoadSegments = in.readIntLine();
+    checkCount(numberOfRoadSegments, "road segments");
+
+    std::vector<int> sources;
+    std::vector<int> targets;
+    std::vector<double> miles;
+    std::vector<double> milesPerHour;
+    sources.reserve(numberOfRoadSegments);
+    targets.reserve(numberOfRoadSegments);
+    miles.reserve(numberOfRoadSegments);
+    milesPerHour.reserve(numberOfRoadSegments);
+
+    for (int i = 0; i < numberOfRoadSegments; ++i)
+    {
+        if (!in.nextLine())
+        {
+            throw InputFormatException("Unexpected end of input");
+        }
+
+        sources.push_back(in.readInt());
+        targets.push_back(in.readInt());
+        miles.push_back(in.readDouble());
+        milesPerHour.push_back(in.readDouble());
+
+        // The same weight rules as RoadMapReader's.
+        if (!(miles.back() >= 0.0) || !(milesPerHour.back() >= 0.0))
+        {
+            throw InputFormatException("Invalid road segment on line: " + in.lineText());
+        }
+    }
+
+    return CompactRoadGraph{
+        std::move(names), std::move(sources), std::move(targets),
+        std::move(miles), std::move(milesPerHour)};
+}
+
+
+std::vector<Trip> FastRoadMapLoader::readTrips(FastInputScanner& in)
+{
+    TraceSpan span{"read trips"};
+
+    int numberOfTrips = in.readIntLine();
+    checkCount(numberOfTrips, "trips");
+
+    std::vector<Trip> trips;
+    trips.reserve(numberOfTrips);
+
+    for (int i = 0; i < numberOfTrips; ++i)
+    {
+        if (!in.nextLine())
+        {
+            throw InputFormatException("Unexpected end of input");
+        }
+
+        int fromVertex = in.readInt();
+        int toVertex = in.readInt();
+
+        const char* metricBegin;
+        const char* metricEnd;
+        in.readWord(metricBegin, metricEnd);
+
+        bool distance = metricEnd - metricBegin == 1 && *metricBegin == 'D';
+        trips.push_back(
+            {fromVertex, toVertex, distance ? TripMetric::Distance : TripMetric::Time});
+    }
+
+    return trips;
+}
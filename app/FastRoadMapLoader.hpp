@@ -0,0 +1,38 @@
+// FastRoadMapLoader.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A FastRoadMapLoader reads the same road map and trips format as
+// RoadMapReader and TripReader, but from a FastInputScanner, and builds a
+// CompactRoadGraph directly instead of a RoadMap.  The declared numbers of
+// locations and road segments are used to reserve every column up front,
+// so loading a large map doesn't reallocate as it goes.
+
+#ifndef FASTROADMAPLOADER_HPP
+#define FASTROADMAPLOADER_HPP
+
+#include <vector>
+#include "CompactRoadGraph.hpp"
+#include "FastInputScanner.hpp"
+#include "Trip.hpp"
+
+
+
+class FastRoadMapLoader
+{
+public:
+    // readRoadMap() reads the locations and road segments from the given
+    // FastInputScanner.  If the input is malformed, or gives a road
+    // segment a negative miles or speed, an InputFormatException is
+    // thrown; if it describes an invalid graph, a DigraphException is
+    // thrown.
+    CompactRoadGraph readRoadMap(FastInputScanner& in);
+
+    // readTrips() reads the trips section from the given FastInputScanner.
+    std::vector<Trip> readTrips(FastInputScanner& in);
+};
+
+
+
+#endif // FASTROADMAPLOADER_HPP
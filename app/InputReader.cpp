@@ -44,6 +44,22 @@ std::string InputReader::readLine()
 }
 
 
+bool InputReader::tryReadLine(std::string& line)
+{
+    while (std::getline(in_, line))
+    {
+        trimRight(line);
+
+        if (line.length() > 0 && line[0] != '#')
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
 int InputReader::readIntLine()
 {
     std::string line = readLine();
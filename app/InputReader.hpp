@@ -33,6 +33,11 @@ public:
     // integer value (e.g., "7").
     int readIntLine();
 
+    // tryReadLine() reads the next meaningful line of input into the given
+    // string, like readLine(), but returns false instead of waiting for
+    // more input once the input stream has run out.
+    bool tryReadLine(std::string& line);
+
 private:
     std::istream& in_;
 };
@@ -0,0 +1,214 @@
+// LandmarkIndex.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include "LandmarkIndex.hpp"
+#include "TraceRecorder.hpp"
+
+
+namespace
+{
+    typedef std::pair<double, int> QueueEntry;
+
+    typedef std::priority_queue<
+        QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> SearchQueue;
+
+    const double infinity = std::numeric_limits<double>::infinity();
+    const int unreached = std::numeric_limits<int>::max();
+
+
+    // Lowers hops[v] to the number of hops between the source vertex and
+    // v, following edges in either direction, wherever that's smaller.
+    void lowerHops(const CompactRoadGraph& graph, int sourceVertex, std::vector<int>& hops)
+    {
+        std::vector<int> frontier{sourceVertex};
+        hops[sourceVertex] = 0;
+
+        for (int depth = 1; !frontier.empty(); ++depth)
+        {
+            std::vector<int> next;
+
+            for (int vertex : frontier)
+            {
+                for (int edge = graph.edgeBegin(vertex); edge < graph.edgeEnd(vertex); ++edge)
+                {
+                    int target = graph.edgeTarget(edge);
+
+                    if (depth < hops[target])
+                    {
+                        hops[target] = depth;
+                        next.push_back(target);
+                    }
+                }
+
+                for (int position = graph.reverseEdgeBegin(vertex);
+                     position < graph.reverseEdgeEnd(vertex); ++position)
+                {
+                    int source = graph.edgeSource(graph.reverseEdge(position));
+
+                    if (depth < hops[source])
+                    {
+                        hops[source] = depth;
+                        next.push_back(source);
+                    }
+                }
+            }
+
+            frontier.swap(next);
+        }
+    }
+
+
+    // Returns the vertex with the most hops, preferring the lowest vertex
+    // number among ties.
+    int farthestVertex(const std::vector<int>& hops)
+    {
+        return static_cast<int>(std::max_element(hops.begin(), hops.end()) - hops.begin());
+    }
+
+
+    // Writes the distance from the source vertex to every vertex into
+    // every landmarkCount-th element of table, starting at the given
+    // column; backward searches follow the edges in reverse, which gives
+    // the distance from every vertex to the source vertex instead.
+    void computeDistances(
+        const CompactRoadGraph& graph, const double* weights, int sourceVertex,
+        bool backward, double* table, int column, int landmarkCount)
+    {
+        std::vector<double> distances(graph.vertexCount(), infinity);
+        SearchQueue queue;
+
+        distances[sourceVertex] = 0.0;
+        queue.push(QueueEntry{0.0, sourceVertex});
+
+        while (!queue.empty())
+        {
+            QueueEntry smallest = queue.top();
+            queue.pop();
+
+            int vertex = smallest.second;
+
+            if (smallest.first > distances[vertex])
+            {
+                continue;
+            }
+
+            int begin = backward ? graph.reverseEdgeBegin(vertex) : graph.edgeBegin(vertex);
+            int end = backward ? graph.reverseEdgeEnd(vertex) : graph.edgeEnd(vertex);
+
+            for (int position = begin; position < end; ++position)
+            {
+                int edge = backward ? graph.reverseEdge(position) : position;
+                int neighbor = backward ? graph.edgeSource(edge) : graph.edgeTarget(edge);
+                double candidate = smallest.first + weights[edge];
+
+                if (candidate < distances[neighbor])
+                {
+                    distances[neighbor] = candidate;
+                    queue.push(QueueEntry{candidate, neighbor});
+                }
+            }
+        }
+
+        for (int vertex = 0; vertex < graph.vertexCount(); ++vertex)
+        {
+            table[static_cast<std::size_t>(vertex) * landmarkCount + column] = distances[vertex];
+        }
+    }
+}
+
+
+LandmarkIndex::LandmarkIndex(
+    const CompactRoadGraph& graph, TripMetric metric,
+    int landmarkCount, WorkStealingPool& pool)
+{
+    TraceSpan span{"choose landmarks"};
+
+    int vertexCount = graph.vertexCount();
+    landmarkCount = std::max(0, std::min(landmarkCount, vertexCount));
+
+    // The first landmark is the vertex farthest from vertex 0; each later
+    // one is the vertex farthest from every landmark chosen so far.
+    std::vector<int> hops(vertexCount, unreached);
+
+    if (landmarkCount > 0)
+    {
+        lowerHops(graph, 0, hops);
+        int first = farthestVertex(hops);
+
+        hops.assign(vertexCount, unreached);
+        lowerHops(graph, first, hops);
+        landmarks_.push_back(first);
+    }
+
+    while (landmarkCount > 0 && static_cast<int>(landmarks_.size()) < landmarkCount)
+    {
+        int next = farthestVertex(hops);
+        lowerHops(graph, next, hops);
+        landmarks_.push_back(next);
+    }
+
+    const double* weights = graph.weightColumn(metric);
+    std::size_t tableSize = static_cast<std::size_t>(vertexCount) * landmarkCount;
+
+    fromLandmarks_.resize(tableSize);
+    toLandmarks_.resize(tableSize);
+
+    pool.parallelFor(
+        2 * landmarkCount,
+        [&](int index, unsigned)
+        {
+            bool backward = index >= landmarkCount;
+            int column = index % landmarkCount;
+
+            computeDistances(
+                graph, weights, landmarks_[column], backward,
+                backward ? toLandmarks_.data() : fromLandmarks_.data(),
+                column, landmarkCount);
+        });
+}
+
+
+LandmarkIndex::Heuristic::Heuristic(const LandmarkIndex& index, int endVertex)
+    : landmarkCount_{index.landmarkCount()},
+      fromLandmarks_{index.fromLandmarks_.data()},
+      toLandmarks_{index.toLandmarks_.data()},
+      endFromLandmarks_{fromLandmarks_ + static_cast<std::size_t>(endVertex) * landmarkCount_},
+      endToLandmarks_{toLandmarks_ + static_cast<std::size_t>(endVertex) * landmarkCount_}
+{
+}
+
+
+// An infinite distance on one side of a bound either makes the bound
+// useless (when the landmark can't reach the vertex, or the end vertex
+// can't reach the landmark) or proves that the end vertex can't be reached
+// from the vertex at all, in which case the bound is infinite.
+double LandmarkIndex::Heuristic::operator()(int vertex) const
+{
+    const double* vertexFromLandmarks = fromLandmarks_ + static_cast<std::size_t>(vertex) * landmarkCount_;
+    const double* vertexToLandmarks = toLandmarks_ + static_cast<std::size_t>(vertex) * landmarkCount_;
+
+    double bound = 0.0;
+
+    for (int i = 0; i < landmarkCount_; ++i)
+    {
+        if (!std::isinf(vertexFromLandmarks[i]))
+        {
+            bound = std::max(bound, endFromLandmarks_[i] - vertexFromLandmarks[i]);
+        }
+
+        if (!std::isinf(endToLandmarks_[i]))
+        {
+            bound = std::max(bound, vertexToLandmarks[i] - endToLandmarks_[i]);
+        }
+    }
+
+    return bound;
+}
@@ -0,0 +1,93 @@
+// LandmarkIndex.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A LandmarkIndex supplies the lower bounds behind ALT searches (A*,
+// Landmarks, and the Triangle inequality), which head toward the end
+// vertex without needing any coordinates.
+//
+// A handful of landmark vertices are chosen spread out across the map, and
+// the distance from every landmark to every vertex and from every vertex
+// to every landmark is computed once, for one TripMetric.  For any
+// landmark L, the triangle inequality gives
+//
+//     dist(v, t) >= dist(L, t) - dist(L, v)
+//     dist(v, t) >= dist(v, L) - dist(t, L)
+//
+// and the largest of these bounds over all landmarks is the heuristic
+// that CompactRoadGraph::findShortestPathGuided() uses to settle the
+// vertices that lie toward the end vertex first.
+//
+// Landmarks are chosen by farthest selection: each new landmark is the
+// vertex that is the most hops away from all of the landmarks chosen so
+// far, which also places one in every part of the map that can't be
+// reached from the others.  The 2k distance tables are independent
+// Dijkstra searches, so they're computed in parallel on a WorkStealingPool.
+//
+// Like a ContractionHierarchy, a LandmarkIndex keeps the weights the graph
+// had when it was built; its bounds become wrong after updateSpeeds().
+
+#ifndef LANDMARKINDEX_HPP
+#define LANDMARKINDEX_HPP
+
+#include <vector>
+#include "CompactRoadGraph.hpp"
+#include "TripMetric.hpp"
+#include "WorkStealingPool.hpp"
+
+
+
+class LandmarkIndex
+{
+public:
+    // A Heuristic returns the lower bound on the distance from any vertex
+    // to one fixed end vertex; findShortestPathGuided() calls it.
+    class Heuristic
+    {
+    public:
+        Heuristic(const LandmarkIndex& index, int endVertex);
+
+        double operator()(int vertex) const;
+
+    private:
+        int landmarkCount_;
+        const double* fromLandmarks_;
+        const double* toLandmarks_;
+        const double* endFromLandmarks_;
+        const double* endToLandmarks_;
+    };
+
+public:
+    // Chooses up to the given number of landmarks in the given graph and
+    // computes their distance tables for the given TripMetric on the given
+    // pool.
+    LandmarkIndex(
+        const CompactRoadGraph& graph, TripMetric metric,
+        int landmarkCount, WorkStealingPool& pool);
+
+    // landmarkCount() returns the number of landmarks actually chosen,
+    // which is never more than the number of vertices.
+    int landmarkCount() const { return static_cast<int>(landmarks_.size()); }
+
+    // landmark() returns the vertex number of the landmark with the given
+    // index.
+    int landmark(int index) const { return landmarks_[index]; }
+
+    // heuristicTo() returns the heuristic for searches that end at the
+    // given vertex.
+    Heuristic heuristicTo(int endVertex) const { return Heuristic{*this, endVertex}; }
+
+private:
+    // Both tables are stored vertex by vertex, so the bounds for one
+    // vertex read landmarkCount() adjacent doubles from each:
+    // fromLandmarks_[v * landmarkCount() + i] is the distance from
+    // landmark i to vertex v, and toLandmarks_ the distance back.
+    std::vector<int> landmarks_;
+    std::vector<double> fromLandmarks_;
+    std::vector<double> toLandmarks_;
+};
+
+
+
+#endif // LANDMARKINDEX_HPP
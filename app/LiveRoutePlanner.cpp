@@ -0,0 +1,130 @@
+// LiveRoutePlanner.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include "LiveRoutePlanner.hpp"
+#include "TraceRecorder.hpp"
+
+
+LiveRoutePlanner::LiveRoutePlanner(
+    CompactRoadGraph& graph, WorkStealingPool& pool, unsigned maxTrees,
+    SearchMetrics* metrics)
+    : graph_{graph}, pool_{pool}, maxTrees_{maxTrees}, metrics_{metrics}
+{
+}
+
+
+std::vector<Route> LiveRoutePlanner::planTrips(const std::vector<Trip>& trips)
+{
+    TraceSpan span{"plan trips"};
+
+    std::vector<TreeKey> missing;
+
+    for (const Trip& trip : trips)
+    {
+        if (!graph_.hasVertex(trip.startVertex) || !graph_.hasVertex(trip.endVertex))
+        {
+            throw DigraphException("Vertex does not exist.");
+        }
+
+        TreeKey key{trip.startVertex, trip.metric};
+        auto found = trees_.find(key);
+
+        if (found == trees_.end())
+        {
+            trees_[key] = CachedTree{nullptr, recency_.insert(recency_.begin(), key)};
+            missing.push_back(key);
+        }
+        else
+        {
+            recency_.splice(recency_.begin(), recency_, found->second.recency);
+        }
+    }
+
+    pool_.parallelFor(
+        static_cast<int>(missing.size()),
+        [&](int index, unsigned)
+        {
+            std::chrono::steady_clock::time_point start;
+
+            if constexpr (searchInstrumentation)
+            {
+                start = std::chrono::steady_clock::now();
+            }
+
+            std::unique_ptr<DynamicShortestPathTree>& tree = trees_.at(missing[index]).tree;
+
+            tree = std::make_unique<DynamicShortestPathTree>(
+                graph_, missing[index].first, missing[index].second);
+            recordSearch(*tree, start);
+        });
+
+    std::vector<Route> routes;
+    routes.reserve(trips.size());
+
+    for (const Trip& trip : trips)
+    {
+        const DynamicShortestPathTree& tree =
+            *trees_.at(TreeKey{trip.startVertex, trip.metric}).tree;
+        routes.push_back(tree.route(trip.endVertex));
+    }
+
+    dropLeastRecentlyUsed();
+    return routes;
+}
+
+
+void LiveRoutePlanner::applySpeedUpdates(const std::vector<SpeedUpdate>& updates)
+{
+    TraceSpan span{"apply speed updates"};
+
+    std::vector<int> changedEdges = graph_.updateSpeeds(updates);
+
+    std::vector<DynamicShortestPathTree*> trees;
+    trees.reserve(trees_.size());
+
+    for (auto& tree : trees_)
+    {
+        trees.push_back(tree.second.tree.get());
+    }
+
+    pool_.parallelFor(
+        static_cast<int>(trees.size()),
+        [&](int index, unsigned)
+        {
+            std::chrono::steady_clock::time_point start;
+
+            if constexpr (searchInstrumentation)
+            {
+                start = std::chrono::steady_clock::now();
+            }
+
+            trees[index]->repair(changedEdges);
+            recordSearch(*trees[index], start);
+        });
+}
+
+
+void LiveRoutePlanner::dropLeastRecentlyUsed()
+{
+    while (trees_.size() > maxTrees_)
+    {
+        trees_.erase(recency_.back());
+        recency_.pop_back();
+    }
+}
+
+
+void LiveRoutePlanner::recordSearch(
+    const DynamicShortestPathTree& tree, std::chrono::steady_clock::time_point start) const
+{
+    if constexpr (searchInstrumentation)
+    {
+        if (metrics_ != nullptr)
+        {
+            metrics_->recordSearch(
+                tree.metric(), tree.counters(), std::chrono::steady_clock::now() - start);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+// LiveRoutePlanner.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A LiveRoutePlanner answers trips against a CompactRoadGraph whose speeds
+// keep changing, as they do when a traffic feed is attached.  It caches one
+// DynamicShortestPathTree per (start vertex, TripMetric) it has been asked
+// about, answers every later trip from that start with the same metric out
+// of the cached tree, and repairs the cached trees incrementally whenever
+// a batch of speed updates arrives, instead of recomputing them.
+//
+// Each tree takes space in proportion to the graph and is repaired on
+// every batch of updates, so only a limited number are kept: once a batch
+// of trips has been answered, the least recently used trees are dropped
+// until no more than the limit remain.  A tree that is dropped is simply
+// grown again the next time a trip needs it.
+//
+// Given SearchMetrics, the planner records every tree it grows, and every
+// repair of a cached tree, as one search for the tree's TripMetric.
+
+#ifndef LIVEROUTEPLANNER_HPP
+#define LIVEROUTEPLANNER_HPP
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "CompactRoadGraph.hpp"
+#include "DynamicShortestPathTree.hpp"
+#include "SearchMetrics.hpp"
+#include "SpeedUpdate.hpp"
+#include "Trip.hpp"
+#include "WorkStealingPool.hpp"
+
+
+
+class LiveRoutePlanner
+{
+public:
+    // Initializes a LiveRoutePlanner for the given graph, running its
+    // searches on the given pool and keeping at most the given number of
+    // trees between batches.  The graph and pool must outlive the planner,
+    // and the graph's speeds must only be changed through
+    // applySpeedUpdates().  If metrics isn't nullptr, every search is
+    // recorded into it, and it must outlive the planner too.
+    LiveRoutePlanner(
+        CompactRoadGraph& graph, WorkStealingPool& pool, unsigned maxTrees,
+        SearchMetrics* metrics = nullptr);
+
+    // planTrips() returns one route per trip, in the same form and order
+    // as TripPlanner::planTrips(), growing trees for any start vertex and
+    // metric that isn't cached yet.  A batch that needs more trees than the
+    // limit keeps all of them until it has been answered.
+    std::vector<Route> planTrips(const std::vector<Trip>& trips);
+
+    // applySpeedUpdates() applies a batch of speed updates to the graph
+    // and repairs every cached tree.  If an update names an edge that does
+    // not exist, a DigraphException is thrown and nothing changes.
+    void applySpeedUpdates(const std::vector<SpeedUpdate>& updates);
+
+    // cachedTreeCount() returns the number of trees currently cached.
+    int cachedTreeCount() const { return static_cast<int>(trees_.size()); }
+
+private:
+    typedef std::pair<int, TripMetric> TreeKey;
+
+    // Each cached tree remembers its place in recency_, which lists the
+    // keys of the cached trees from most to least recently used.
+    struct CachedTree
+    {
+        std::unique_ptr<DynamicShortestPathTree> tree;
+        std::list<TreeKey>::iterator recency;
+    };
+
+    // dropLeastRecentlyUsed() drops trees until no more than maxTrees_
+    // remain.
+    void dropLeastRecentlyUsed();
+
+    // recordSearch() records the work the given tree just did, which took
+    // the time since the given start, into the metrics, if there are any.
+    void recordSearch(
+        const DynamicShortestPathTree& tree, std::chrono::steady_clock::time_point start) const;
+
+private:
+    CompactRoadGraph& graph_;
+    WorkStealingPool& pool_;
+    unsigned maxTrees_;
+    SearchMetrics* metrics_;
+    std::map<TreeKey, CachedTree> trees_;
+    std::list<TreeKey> recency_;
+};
+
+
+
+#endif // LIVEROUTEPLANNER_HPP
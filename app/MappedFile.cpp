@@ -0,0 +1,57 @@
+// MappedFile.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MappedFile.hpp"
+
+
+MappedFile::MappedFile(const std::string& path)
+    : data_{nullptr}, size_{0}
+{
+    int fd = open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+    {
+        throw MappedFileException("Could not open " + path);
+    }
+
+    struct stat status;
+
+    if (fstat(fd, &status) != 0)
+    {
+        close(fd);
+        throw MappedFileException("Could not read the size of " + path);
+    }
+
+    size_ = static_cast<std::size_t>(status.st_size);
+
+    if (size_ > 0)
+    {
+        void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping == MAP_FAILED)
+        {
+            close(fd);
+            throw MappedFileException("Could not map " + path);
+        }
+
+        madvise(mapping, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(mapping);
+    }
+
+    close(fd);
+}
+
+
+MappedFile::~MappedFile()
+{
+    if (data_ != nullptr)
+    {
+        munmap(const_cast<char*>(data_), size_);
+    }
+}
@@ -0,0 +1,58 @@
+// MappedFile.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A MappedFile maps a whole file read-only into memory, so that its
+// contents can be scanned in place without being copied through an
+// istream.  The mapping is released when the MappedFile is destroyed.
+// This relies on POSIX mmap().
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+
+
+// A MappedFileException is thrown when a file can't be opened or mapped.
+
+class MappedFileException
+{
+public:
+    MappedFileException(const std::string& reason): reason_{reason} { }
+
+    std::string reason() const { return reason_; }
+
+private:
+    std::string reason_;
+};
+
+
+
+class MappedFile
+{
+public:
+    // Maps the file with the given path.  If that fails, a
+    // MappedFileException is thrown instead.
+    explicit MappedFile(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // data() and size() describe the file's contents.  An empty file has
+    // a size of 0 and a null data pointer.
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+};
+
+
+
+#endif // MAPPEDFILE_HPP
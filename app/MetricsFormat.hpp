@@ -0,0 +1,25 @@
+// MetricsFormat.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A MetricsFormat describes how the program dumps the SearchMetrics it
+// collected, if at all: as a JSON object, or in the Prometheus text
+// exposition format, which a Prometheus node exporter can pick up from a
+// file.
+
+#ifndef METRICSFORMAT_HPP
+#define METRICSFORMAT_HPP
+
+
+
+enum class MetricsFormat
+{
+    None,
+    Json,
+    Prometheus
+};
+
+
+
+#endif // METRICSFORMAT_HPP
@@ -0,0 +1,64 @@
+// MetricsSignalWatcher.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <pthread.h>
+#include <signal.h>
+#include <utility>
+#include "MetricsSignalWatcher.hpp"
+
+
+namespace
+{
+    sigset_t watchedSignals()
+    {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGUSR1);
+        return signals;
+    }
+}
+
+
+MetricsSignalWatcher::MetricsSignalWatcher(std::function<void()> onSignal)
+    : onSignal_{std::move(onSignal)}, stopping_{false}
+{
+    sigset_t signals = watchedSignals();
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    thread_ = std::thread{[this]() { watch(); }};
+}
+
+
+MetricsSignalWatcher::~MetricsSignalWatcher()
+{
+    // The waiting thread can only be woken by the signal it waits for, so
+    // it's sent one directly after being told to stop.
+    stopping_.store(true);
+    pthread_kill(thread_.native_handle(), SIGUSR1);
+    thread_.join();
+}
+
+
+void MetricsSignalWatcher::watch()
+{
+    sigset_t signals = watchedSignals();
+
+    while (true)
+    {
+        int signal;
+
+        if (sigwait(&signals, &signal) != 0)
+        {
+            continue;
+        }
+
+        if (stopping_.load())
+        {
+            return;
+        }
+
+        onSignal_();
+    }
+}
@@ -0,0 +1,53 @@
+// MetricsSignalWatcher.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A MetricsSignalWatcher lets the metrics of a long run be dumped while it
+// is still going: every time the process receives SIGUSR1, it calls the
+// function it was given.
+//
+// Rather than doing the work in a signal handler, where almost nothing is
+// safe to call, the watcher blocks SIGUSR1 and waits for it with sigwait()
+// on a thread of its own, so the function may lock mutexes and write to
+// streams like any other code.  Threads inherit the signal mask of the
+// thread that starts them, so the watcher must be constructed before any
+// other thread (such as the workers of a WorkStealingPool) is started;
+// otherwise a SIGUSR1 delivered to one of those threads would kill the
+// process.
+
+#ifndef METRICSSIGNALWATCHER_HPP
+#define METRICSSIGNALWATCHER_HPP
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+
+
+class MetricsSignalWatcher
+{
+public:
+    // Blocks SIGUSR1 in the calling thread and starts the thread that
+    // waits for it.
+    explicit MetricsSignalWatcher(std::function<void()> onSignal);
+
+    // The destructor wakes the waiting thread and joins it.  SIGUSR1 stays
+    // blocked.
+    ~MetricsSignalWatcher();
+
+    MetricsSignalWatcher(const MetricsSignalWatcher&) = delete;
+    MetricsSignalWatcher& operator=(const MetricsSignalWatcher&) = delete;
+
+private:
+    void watch();
+
+private:
+    std::function<void()> onSignal_;
+    std::atomic<bool> stopping_;
+    std::thread thread_;
+};
+
+
+
+#endif // METRICSSIGNALWATCHER_HPP
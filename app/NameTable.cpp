@@ -0,0 +1,27 @@
+// NameTable.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include "NameTable.hpp"
+
+
+NameTable::NameTable()
+    : offsets_{0}
+{
+}
+
+
+void NameTable::reserve(int nameCount, std::size_t charCount)
+{
+    offsets_.reserve(static_cast<std::size_t>(nameCount) + 1);
+    chars_.reserve(charCount);
+}
+
+
+int NameTable::add(std::string_view name)
+{
+    chars_.insert(chars_.end(), name.begin(), name.end());
+    offsets_.push_back(static_cast<std::int64_t>(chars_.size()));
+    return size() - 1;
+}
@@ -0,0 +1,61 @@
+// NameTable.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A NameTable holds a sequence of names laid end to end in one block of
+// characters, along with the offset at which each one begins, so that a
+// million location names cost two allocations rather than a million.
+// Name i is the characters in [offsets()[i], offsets()[i + 1]), which is
+// the same layout as the name columns of a CompactRoadGraph and of a
+// snapshot, and name() hands it out as a std::string_view into the block
+// without copying anything.
+//
+// The views returned by name() remain valid until the next call to add()
+// (which may grow the block) or until the NameTable is destroyed.
+
+#ifndef NAMETABLE_HPP
+#define NAMETABLE_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+
+
+class NameTable
+{
+public:
+    // The default constructor initializes an empty NameTable.
+    NameTable();
+
+    // reserve() makes room for the given number of names containing the
+    // given number of characters altogether.
+    void reserve(int nameCount, std::size_t charCount);
+
+    // add() appends a copy of the given name and returns its index.
+    int add(std::string_view name);
+
+    // size() returns the number of names in the table.
+    int size() const { return static_cast<int>(offsets_.size()) - 1; }
+
+    // name() returns the name with the given index, which must exist.
+    std::string_view name(int index) const
+    {
+        return std::string_view{
+            chars_.data() + offsets_[index],
+            static_cast<std::size_t>(offsets_[index + 1] - offsets_[index])};
+    }
+
+    // offsets() and chars() return the two columns that make up the table.
+    const std::vector<std::int64_t>& offsets() const { return offsets_; }
+    const std::vector<char>& chars() const { return chars_; }
+
+private:
+    std::vector<std::int64_t> offsets_;
+    std::vector<char> chars_;
+};
+
+
+
+#endif // NAMETABLE_HPP
@@ -0,0 +1,50 @@
+// QueryWorkspace.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include "QueryWorkspace.hpp"
+
+
+QueryWorkspace::QueryWorkspace()
+    : generation_{0}
+{
+}
+
+
+void QueryWorkspace::prepare(int vertexCount)
+{
+    queue_.clear();
+    counters_ = SearchCounters{};
+
+    if (static_cast<int>(stamps_.size()) < vertexCount)
+    {
+        stamps_.resize(vertexCount, generation_);
+        distances_.resize(vertexCount);
+        predecessors_.resize(vertexCount);
+        predecessorEdges_.resize(vertexCount);
+        settled_.resize(vertexCount);
+    }
+
+    // Generation 0 is never used by a search, so stamps that were cleared
+    // (or added by the resize above) never look reached.
+    if (++generation_ == 0)
+    {
+        std::fill(stamps_.begin(), stamps_.end(), 0);
+        generation_ = 1;
+    }
+}
+
+
+std::vector<int> QueryWorkspace::traceEdges(int startVertex, int endVertex) const
+{
+    std::vector<int> edges;
+
+    for (int vertex = endVertex; vertex != startVertex; vertex = predecessors_[vertex])
+    {
+        edges.push_back(predecessorEdges_[vertex]);
+    }
+
+    std::reverse(edges.begin(), edges.end());
+    return edges;
+}
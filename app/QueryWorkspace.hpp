@@ -0,0 +1,128 @@
+// QueryWorkspace.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A QueryWorkspace holds the scratch state of one shortest path search:
+// a distance, a predecessor, a predecessor edge and a settled flag for
+// every vertex, plus the search's priority queue.  The arrays are sized to
+// the graph once and then reused by every search, so a search that only
+// touches a few dozen vertices costs a few dozen vertices' worth of work.
+//
+// Instead of clearing the arrays between searches, each entry carries the
+// generation in which it was last written, and prepare() simply starts a
+// new generation, so every entry from an earlier search reads as unreached.
+// Only when the generation counter wraps around are the stamps cleared.
+//
+// The workspace also carries the SearchCounters of the search using it,
+// which prepare() resets and push() advances; the search counts the rest.
+//
+// A QueryWorkspace must only be used by one search at a time; keep one per
+// worker thread (WorkStealingPool tells each task which worker runs it).
+
+#ifndef QUERYWORKSPACE_HPP
+#define QUERYWORKSPACE_HPP
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "SearchCounters.hpp"
+
+
+
+class QueryWorkspace
+{
+public:
+    typedef std::pair<double, int> QueueEntry;
+
+public:
+    // The default constructor initializes an empty workspace; the first
+    // call to prepare() sizes it.
+    QueryWorkspace();
+
+    // prepare() starts a new search over a graph with the given number of
+    // vertices: every vertex becomes unreached and the queue is emptied.
+    void prepare(int vertexCount);
+
+    // reached() returns true if the given vertex has been labeled in the
+    // current search.
+    bool reached(int vertex) const { return stamps_[vertex] == generation_; }
+
+    // distance() returns the distance label of the given vertex, which is
+    // infinite if it hasn't been reached.
+    double distance(int vertex) const
+    {
+        return reached(vertex) ? distances_[vertex] : std::numeric_limits<double>::infinity();
+    }
+
+    // predecessor() and predecessorEdge() return the vertex and the edge
+    // through which the given reached vertex got its label.
+    int predecessor(int vertex) const { return predecessors_[vertex]; }
+    int predecessorEdge(int vertex) const { return predecessorEdges_[vertex]; }
+
+    // settled() returns true if settle() has been called for the given
+    // vertex in the current search.
+    bool settled(int vertex) const { return reached(vertex) && settled_[vertex]; }
+
+    // label() gives the given vertex a new distance label, along with the
+    // predecessor and edge it was reached through.
+    void label(int vertex, double distance, int predecessor, int edge)
+    {
+        if (!reached(vertex))
+        {
+            stamps_[vertex] = generation_;
+            settled_[vertex] = 0;
+        }
+
+        distances_[vertex] = distance;
+        predecessors_[vertex] = predecessor;
+        predecessorEdges_[vertex] = edge;
+    }
+
+    // settle() marks the given reached vertex as settled.
+    void settle(int vertex) { settled_[vertex] = 1; }
+
+    // The queue is a binary min-heap kept in a vector that's reused from
+    // search to search, so pushing rarely allocates.
+    bool queueEmpty() const { return queue_.empty(); }
+    const QueueEntry& queueTop() const { return queue_.front(); }
+
+    void push(const QueueEntry& entry)
+    {
+        counters_.countPush();
+        queue_.push_back(entry);
+        std::push_heap(queue_.begin(), queue_.end(), std::greater<QueueEntry>{});
+    }
+
+    void pop()
+    {
+        std::pop_heap(queue_.begin(), queue_.end(), std::greater<QueueEntry>{});
+        queue_.pop_back();
+    }
+
+    // counters() returns the SearchCounters of the current search.
+    SearchCounters& counters() { return counters_; }
+    const SearchCounters& counters() const { return counters_; }
+
+    // traceEdges() walks the predecessors back from the end vertex, which
+    // must have been reached, and returns the predecessor edges along the
+    // path in start-to-end order.
+    std::vector<int> traceEdges(int startVertex, int endVertex) const;
+
+private:
+    std::vector<unsigned> stamps_;
+    unsigned generation_;
+
+    std::vector<double> distances_;
+    std::vector<int> predecessors_;
+    std::vector<int> predecessorEdges_;
+    std::vector<char> settled_;
+    std::vector<QueueEntry> queue_;
+    SearchCounters counters_;
+};
+
+
+
+#endif // QUERYWORKSPACE_HPP
@@ -0,0 +1,24 @@
+// ReportFormat.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A ReportFormat describes how the program writes out the route it found
+// for each trip: as the readable "Begin at / Continue to / Total" report,
+// or as JSON Lines, one JSON object per trip, for programs that consume
+// the output of large batches.
+
+#ifndef REPORTFORMAT_HPP
+#define REPORTFORMAT_HPP
+
+
+
+enum class ReportFormat
+{
+    Text,
+    JsonLines
+};
+
+
+
+#endif // REPORTFORMAT_HPP
@@ -5,7 +5,11 @@
 //
 // This header defines a type RoadMap, which is simply a typedef to a particular
 // instantiation of the Digraph template, where each vertex has a string for its
-// information and each edge has a RoadSegment for its information.
+// information and each edge has a RoadSegment for its information.  Since
+// RoadMapReader numbers the vertices 0..N-1, a RoadMap stores them densely,
+// with DenseVertexStorage: a std::pmr::deque indexed by vertex number, plus
+// a bitmap of the slots in use.  It's a deque rather than a vector so that
+// a vertex never moves once stored (see DigraphStorage.hpp).
 
 #ifndef ROADMAP_HPP
 #define ROADMAP_HPP
@@ -16,7 +20,7 @@
 
 
 
-typedef Digraph<std::string, RoadSegment> RoadMap;
+typedef Digraph<std::string, RoadSegment, DenseVertexStorage> RoadMap;
 
 
 
@@ -5,12 +5,17 @@
 
 #include <algorithm>
 #include <sstream>
+#include <string>
+#include "FastInputScanner.hpp"
 #include "RoadMapReader.hpp"
+#include "TraceRecorder.hpp"
 
 
-RoadMap RoadMapReader::readRoadMap(InputReader& in)
+RoadMap RoadMapReader::readRoadMap(InputReader& in, std::pmr::memory_resource* resource)
 {
-    RoadMap roadMap;
+    TraceSpan span{"read road map"};
+
+    RoadMap roadMap{resource};
 
     int numberOfLocations = in.readIntLine();
 
@@ -23,7 +28,8 @@ RoadMap RoadMapReader::readRoadMap(InputReader& in)
 
     for (int i = 0; i < numberOfRoadSegments; ++i)
     {
-        std::istringstream roadSegmentLine{in.readLine()};
+        std::string line = in.readLine();
+        std::istringstream roadSegmentLine{line};
 
         int fromLocation;
         int toLocation;
@@ -32,6 +38,13 @@ RoadMap RoadMapReader::readRoadMap(InputReader& in)
 
         roadSegmentLine >> fromLocation >> toLocation >> miles >> milesPerHour;
 
+        // A negative weight would break every search, and the snapshot
+        // reader rejects one, so it's rejected here too.
+        if (!roadSegmentLine || !(miles >= 0.0) || !(milesPerHour >= 0.0))
+        {
+            throw InputFormatException("Invalid road segment on line: " + line);
+        }
+
         roadMap.addEdge(fromLocation, toLocation, RoadSegment{miles, milesPerHour});
     }
 
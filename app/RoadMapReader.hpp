@@ -10,6 +10,7 @@
 #ifndef ROADMAPREADER_HPP
 #define ROADMAPREADER_HPP
 
+#include <memory_resource>
 #include "RoadMap.hpp"
 #include "InputReader.hpp"
 
@@ -20,8 +21,13 @@ class RoadMapReader
 public:
     // readRoadMap() reads a RoadMap from the given InputReader.  The
     // RoadMap is expected to be described in the format given in the
-    // project write-up.
-    RoadMap readRoadMap(InputReader& in);
+    // project write-up.  Its vertices and edges are allocated from the
+    // given memory resource, which must outlive it.  A road segment whose
+    // line can't be read, or whose miles or speed is negative or not a
+    // number, is an InputFormatException.
+    RoadMap readRoadMap(
+        InputReader& in,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 };
 
 
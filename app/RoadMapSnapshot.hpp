@@ -0,0 +1,90 @@
+// RoadMapSnapshot.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A road map snapshot is a binary file holding every column of a
+// CompactRoadGraph, laid out so that RoadMapSnapshotReader can map the file
+// into memory and query it in place, with no parsing and no per-vertex
+// allocation.  RoadMapWriter::writeSnapshot() writes them.
+//
+// The file starts with a RoadMapSnapshotHeader, followed by the sections
+// it lists, each starting at an offset that is a multiple of 8 bytes:
+//
+//     offsets          int32[vertexCount + 1]
+//     sources          int32[edgeCount]
+//     targets          int32[edgeCount]
+//     miles            float64[edgeCount]
+//     milesPerHour     float64[edgeCount]
+//     timeWeights      float64[edgeCount]
+//     reverseOffsets   int32[vertexCount + 1]
+//     reverseEdges     int32[edgeCount]
+//     nameOffsets      int64[vertexCount + 1]
+//     nameChars        char[nameOffsets[vertexCount]]
+//
+// Values are stored in the byte order of the machine that wrote the file;
+// the byteOrder field lets a reader on a different machine reject it.
+
+#ifndef ROADMAPSNAPSHOT_HPP
+#define ROADMAPSNAPSHOT_HPP
+
+#include <cstdint>
+#include <string>
+
+
+
+// A SnapshotException is thrown when a snapshot can't be written, or when
+// a file isn't a snapshot this program can read.
+
+class SnapshotException
+{
+public:
+    SnapshotException(const std::string& reason): reason_{reason} { }
+
+    std::string reason() const { return reason_; }
+
+private:
+    std::string reason_;
+};
+
+
+
+namespace RoadMapSnapshot
+{
+    const char magic[8] = {'R', 'O', 'A', 'D', 'S', 'N', 'A', 'P'};
+    const std::uint32_t version = 1;
+    const std::uint32_t byteOrder = 0x01020304;
+
+    enum Section
+    {
+        Offsets,
+        Sources,
+        Targets,
+        Miles,
+        MilesPerHour,
+        TimeWeights,
+        ReverseOffsets,
+        ReverseEdges,
+        NameOffsets,
+        NameChars,
+        SectionCount
+    };
+}
+
+
+
+struct RoadMapSnapshotHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::int64_t vertexCount;
+    std::int64_t edgeCount;
+    std::int64_t nameBytes;
+    std::uint64_t sectionOffsets[RoadMapSnapshot::SectionCount];
+    std::uint64_t sectionSizes[RoadMapSnapshot::SectionCount];
+};
+
+
+
+#endif // ROADMAPSNAPSHOT_HPP
@@ -0,0 +1,173 @@
+// RoadMapSnapshotReader.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include "MappedFile.hpp"
+#include "RoadMapSnapshotReader.hpp"
+#include "TraceRecorder.hpp"
+
+
+namespace
+{
+    // Returns a pointer to the given section after checking that it lies
+    // within the file, is aligned, and holds the expected number of bytes.
+    template <typename T>
+    const T* section(
+        const MappedFile& file, const RoadMapSnapshotHeader& header,
+        RoadMapSnapshot::Section which, std::int64_t count)
+    {
+        std::uint64_t offset = header.sectionOffsets[which];
+        std::uint64_t size = header.sectionSizes[which];
+
+        if (size != static_cast<std::uint64_t>(count) * sizeof(T)
+            || offset % 8 != 0 || offset > file.size() || size > file.size() - offset)
+        {
+            throw SnapshotException("Snapshot section is out of bounds");
+        }
+
+        return reinterpret_cast<const T*>(file.data() + offset);
+    }
+
+
+    // Checks that an offsets column starts at 0, never decreases, and ends
+    // at the given total.
+    template <typename T>
+    bool offsetsValid(const T* offsets, int vertexCount, std::int64_t total)
+    {
+        if (offsets[0] != 0 || offsets[vertexCount] != total)
+        {
+            return false;
+        }
+
+        for (int vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            if (offsets[vertex + 1] < offsets[vertex])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    // Checks the contents of every column in one pass over the vertices
+    // and one over the edges, so that a damaged snapshot is rejected
+    // instead of sending a search outside the mapping.  Besides the
+    // bounds, each edge must be listed under its own source in the forward
+    // lists and under its own target in the reverse lists, and no weight
+    // may be negative or not a number.
+    void validateColumns(
+        const std::string& path, const CompactRoadColumns& columns, std::int64_t nameBytes)
+    {
+        int vertexCount = columns.vertexCount;
+        int edgeCount = columns.edgeCount;
+
+        if (!offsetsValid(columns.offsets, vertexCount, edgeCount)
+            || !offsetsValid(columns.reverseOffsets, vertexCount, edgeCount)
+            || !offsetsValid(columns.nameOffsets, vertexCount, nameBytes))
+        {
+            throw SnapshotException(path + " has invalid offsets");
+        }
+
+        for (int vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            for (int edge = columns.offsets[vertex]; edge < columns.offsets[vertex + 1]; ++edge)
+            {
+                if (columns.sources[edge] != vertex
+                    || columns.targets[edge] < 0 || columns.targets[edge] >= vertexCount)
+                {
+                    throw SnapshotException(path + " has an invalid edge");
+                }
+            }
+
+            for (int position = columns.reverseOffsets[vertex];
+                 position < columns.reverseOffsets[vertex + 1]; ++position)
+            {
+                int edge = columns.reverseEdges[position];
+
+                if (edge < 0 || edge >= edgeCount || columns.targets[edge] != vertex)
+                {
+                    throw SnapshotException(path + " has an invalid reverse edge");
+                }
+            }
+        }
+
+        for (int edge = 0; edge < edgeCount; ++edge)
+        {
+            if (!(columns.miles[edge] >= 0.0) || !(columns.milesPerHour[edge] >= 0.0)
+                || !(columns.timeWeights[edge] >= 0.0))
+            {
+                throw SnapshotException(path + " has an invalid edge weight");
+            }
+        }
+    }
+}
+
+
+CompactRoadGraph RoadMapSnapshotReader::readSnapshot(const std::string& path)
+{
+    TraceSpan span{"load snapshot"};
+
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(path);
+
+    RoadMapSnapshotHeader header;
+
+    if (file->size() < sizeof(header))
+    {
+        throw SnapshotException(path + " is too short to be a snapshot");
+    }
+
+    std::memcpy(&header, file->data(), sizeof(header));
+
+    if (std::memcmp(header.magic, RoadMapSnapshot::magic, sizeof(header.magic)) != 0)
+    {
+        throw SnapshotException(path + " is not a road map snapshot");
+    }
+
+    if (header.version != RoadMapSnapshot::version)
+    {
+        throw SnapshotException(path + " has unsupported snapshot version "
+                                + std::to_string(header.version));
+    }
+
+    if (header.byteOrder != RoadMapSnapshot::byteOrder)
+    {
+        throw SnapshotException(path + " was written on a machine with a different byte order");
+    }
+
+    const std::int64_t maxCount = std::numeric_limits<int>::max() - 1;
+
+    if (header.vertexCount < 0 || header.vertexCount > maxCount
+        || header.edgeCount < 0 || header.edgeCount > maxCount || header.nameBytes < 0)
+    {
+        throw SnapshotException(path + " has invalid counts");
+    }
+
+    using namespace RoadMapSnapshot;
+    const MappedFile& f = *file;
+    std::int64_t vertices = header.vertexCount;
+    std::int64_t edges = header.edgeCount;
+
+    CompactRoadColumns columns{
+        static_cast<int>(vertices),
+        static_cast<int>(edges),
+        section<int>(f, header, Offsets, vertices + 1),
+        section<int>(f, header, Sources, edges),
+        section<int>(f, header, Targets, edges),
+        section<double>(f, header, Miles, edges),
+        section<double>(f, header, MilesPerHour, edges),
+        section<double>(f, header, TimeWeights, edges),
+        section<int>(f, header, ReverseOffsets, vertices + 1),
+        section<int>(f, header, ReverseEdges, edges),
+        section<std::int64_t>(f, header, NameOffsets, vertices + 1),
+        section<char>(f, header, NameChars, header.nameBytes)};
+
+    validateColumns(path, columns, header.nameBytes);
+
+    return CompactRoadGraph{columns, file};
+}
@@ -0,0 +1,34 @@
+// RoadMapSnapshotReader.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// The RoadMapSnapshotReader class loads a binary road map snapshot (see
+// RoadMapSnapshot.hpp) by mapping it into memory.  The CompactRoadGraph it
+// returns reads its columns straight out of the mapping, which stays open
+// for as long as the graph exists.
+
+#ifndef ROADMAPSNAPSHOTREADER_HPP
+#define ROADMAPSNAPSHOTREADER_HPP
+
+#include <string>
+#include "CompactRoadGraph.hpp"
+#include "RoadMapSnapshot.hpp"
+
+
+
+class RoadMapSnapshotReader
+{
+public:
+    // readSnapshot() maps the snapshot with the given path and returns a
+    // CompactRoadGraph that views it.  Besides the header and the section
+    // bounds, the columns are checked in one pass over the vertices and
+    // edges, without copying them.  If the file can't be mapped, a
+    // MappedFileException is thrown; if it isn't a valid snapshot, a
+    // SnapshotException is thrown.
+    CompactRoadGraph readSnapshot(const std::string& path);
+};
+
+
+
+#endif // ROADMAPSNAPSHOTREADER_HPP
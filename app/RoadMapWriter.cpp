@@ -3,31 +3,108 @@
 // ICS 46 Spring 2017
 // Project #4: Rock and Roll Stops the Traffic
 
+#include <cstring>
 #include "RoadMapWriter.hpp"
+#include "RoadMapSnapshot.hpp"
+#include "TraceRecorder.hpp"
+
+
+namespace
+{
+    std::uint64_t alignedSize(std::uint64_t size)
+    {
+        return (size + 7) / 8 * 8;
+    }
+}
 
 
 void RoadMapWriter::writeRoadMap(std::ostream& out, const RoadMap& roadMap)
 {
-    out << "LOCATIONS" << std::endl;
+    out << "LOCATIONS\n";
+
+    roadMap.forEachVertex(
+        [&](int vertex, const std::string& name)
+        {
+            out << "    " << vertex << ": " << name << "\n";
+        });
+
+    out << "\n";
+    out << "ROAD SEGMENTS\n";
+
+    roadMap.forEachEdge(
+        [&](const DigraphEdge<RoadSegment>& edge)
+        {
+            out << "    " << edge.fromVertex << "," << edge.toVertex << ": ";
+            out << edge.einfo.miles << "miles; " << edge.einfo.milesPerHour << "mph";
+
+            out << "\n";
+        });
+
+    out << "\n";
+    out.flush();
+}
+
+
+
+void RoadMapWriter::writeSnapshot(std::ostream& out, const CompactRoadGraph& graph)
+{
+    TraceSpan span{"write snapshot"};
+
+    CompactRoadColumns columns = graph.columns();
+    std::int64_t vertices = columns.vertexCount;
+    std::int64_t edges = columns.edgeCount;
+    std::int64_t nameBytes = columns.nameOffsets[vertices];
+
+    const void* data[RoadMapSnapshot::SectionCount] = {
+        columns.offsets, columns.sources, columns.targets,
+        columns.miles, columns.milesPerHour, columns.timeWeights,
+        columns.reverseOffsets, columns.reverseEdges,
+        columns.nameOffsets, columns.nameChars};
+
+    RoadMapSnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, RoadMapSnapshot::magic, sizeof(header.magic));
+    header.version = RoadMapSnapshot::version;
+    header.byteOrder = RoadMapSnapshot::byteOrder;
+    header.vertexCount = vertices;
+    header.edgeCount = edges;
+    header.nameBytes = nameBytes;
+
+    using namespace RoadMapSnapshot;
+    header.sectionSizes[Offsets] = (vertices + 1) * sizeof(int);
+    header.sectionSizes[Sources] = edges * sizeof(int);
+    header.sectionSizes[Targets] = edges * sizeof(int);
+    header.sectionSizes[Miles] = edges * sizeof(double);
+    header.sectionSizes[MilesPerHour] = edges * sizeof(double);
+    header.sectionSizes[TimeWeights] = edges * sizeof(double);
+    header.sectionSizes[ReverseOffsets] = (vertices + 1) * sizeof(int);
+    header.sectionSizes[ReverseEdges] = edges * sizeof(int);
+    header.sectionSizes[NameOffsets] = (vertices + 1) * sizeof(std::int64_t);
+    header.sectionSizes[NameChars] = nameBytes;
 
-    for (int vertex : roadMap.vertices())
+    std::uint64_t offset = alignedSize(sizeof(header));
+
+    for (int s = 0; s < SectionCount; ++s)
     {
-        out << "    " << vertex << ": " << roadMap.vertexInfo(vertex) << std::endl;
+        header.sectionOffsets[s] = offset;
+        offset += alignedSize(header.sectionSizes[s]);
     }
 
-    out << std::endl;
-    out << "ROAD SEGMENTS" << std::endl;
+    const char padding[8] = {};
 
-    for (std::pair<int, int> edge : roadMap.edges())
-    {
-        out << "    " << edge.first << "," << edge.second << ": ";
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(padding, alignedSize(sizeof(header)) - sizeof(header));
 
-        RoadSegment segment = roadMap.edgeInfo(edge.first, edge.second);
-        out << segment.miles << "miles; " << segment.milesPerHour << "mph";
+    for (int s = 0; s < SectionCount; ++s)
+    {
+        std::uint64_t size = header.sectionSizes[s];
 
-        out << std::endl;
+        out.write(static_cast<const char*>(data[s]), size);
+        out.write(padding, alignedSize(size) - size);
     }
 
-    out << std::endl;
+    if (!out)
+    {
+        throw SnapshotException("Unable to write the snapshot");
+    }
 }
-
@@ -7,12 +7,17 @@
 // stream in a format that allows you to see information about it.  This
 // is provided purely as a debugging aid; you don't actually need it to
 // solve the problem at hand.
+//
+// It can also write a frozen road map as a binary snapshot (see
+// RoadMapSnapshot.hpp), which RoadMapSnapshotReader loads much faster than
+// the text format can be parsed.
 
 #ifndef ROADMAPWRITER_HPP
 #define ROADMAPWRITER_HPP
 
 #include <ostream>
 #include "RoadMap.hpp"
+#include "CompactRoadGraph.hpp"
 
 
 
@@ -23,6 +28,11 @@ public:
     // you could pass std::cout to write it to the console) in a format
     // that's designed to assist in debugging.
     void writeRoadMap(std::ostream& out, const RoadMap& roadMap);
+
+    // writeSnapshot() writes a binary snapshot of the given graph to the
+    // given output stream, which should have been opened in binary mode.
+    // A SnapshotException is thrown if the stream fails.
+    void writeSnapshot(std::ostream& out, const CompactRoadGraph& graph);
 };
 
 
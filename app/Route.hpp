@@ -0,0 +1,56 @@
+// Route.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A Route is the answer to one trip: the stops from the start vertex to the
+// end vertex, each with the edge that leads into it, that edge's
+// RoadSegment, and the miles and driving time from the start of the route
+// up to and including that stop.  The first stop is the start vertex
+// itself, reached through no edge (-1) with an all-zero RoadSegment and
+// nothing driven yet.  A Route with no stops at all means that the end
+// vertex can't be reached.
+//
+// A Route is filled in by CompactRoadGraph::makeRoute() straight from the
+// edge indices a search recorded, so printing it never has to look an edge
+// up by its endpoints.  The names are views into the graph's name column
+// and stay valid for as long as the graph does.
+
+#ifndef ROUTE_HPP
+#define ROUTE_HPP
+
+#include <string_view>
+#include <vector>
+#include "RoadSegment.hpp"
+
+
+
+struct RouteStop
+{
+    int vertex;
+    int edge;
+    std::string_view name;
+    RoadSegment segment;
+    double miles;
+    double seconds;
+};
+
+
+
+struct Route
+{
+    std::vector<RouteStop> stops;
+
+    // empty() returns true if the route has no stops, which is how an
+    // unreachable end vertex is reported.
+    bool empty() const { return stops.empty(); }
+
+    // totalMiles() and totalSeconds() return the length and driving time
+    // of the whole route.
+    double totalMiles() const { return stops.empty() ? 0.0 : stops.back().miles; }
+    double totalSeconds() const { return stops.empty() ? 0.0 : stops.back().seconds; }
+};
+
+
+
+#endif // ROUTE_HPP
@@ -0,0 +1,295 @@
+// RouteReportWriter.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include "RouteReportWriter.hpp"
+#include "TraceRecorder.hpp"
+
+
+namespace
+{
+    // The trips are formatted in blocks of this many, and this many blocks
+    // per worker are formatted before their buffers are written out.
+    const int tripsPerBlock = 256;
+    const int blocksPerWorker = 4;
+
+
+    // Large enough for any double in fixed notation, which can have more
+    // than three hundred digits before the decimal point.
+    const int maxNumberLength = std::numeric_limits<double>::max_exponent10 + 32;
+
+
+    void appendInt(std::string& buffer, long long value)
+    {
+        char digits[24];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, result.ptr);
+    }
+
+
+    // Appends the value with two digits after the decimal point, exactly as
+    // an ostream set to std::fixed and std::setprecision(2) writes it.
+    void appendFixed(std::string& buffer, double value)
+    {
+        char digits[maxNumberLength];
+        std::to_chars_result result = std::to_chars(
+            digits, digits + sizeof(digits), value, std::chars_format::fixed, 2);
+        buffer.append(digits, result.ptr);
+    }
+
+
+    // Appends the shortest text that reads back as exactly the value, or
+    // null if the value can't be written as a JSON number.
+    void appendJsonNumber(std::string& buffer, double value)
+    {
+        if (!std::isfinite(value))
+        {
+            buffer += "null";
+            return;
+        }
+
+        char digits[maxNumberLength];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, result.ptr);
+    }
+
+
+    void appendJsonString(std::string& buffer, std::string_view text)
+    {
+        const char hexDigits[] = "0123456789abcdef";
+
+        buffer += '"';
+
+        for (char c : text)
+        {
+            unsigned char byte = static_cast<unsigned char>(c);
+
+            if (c == '"' || c == '\\')
+            {
+                buffer += '\\';
+                buffer += c;
+            }
+            else if (byte < 0x20)
+            {
+                buffer += "\\u00";
+                buffer += hexDigits[byte >> 4];
+                buffer += hexDigits[byte & 0xf];
+            }
+            else
+            {
+                buffer += c;
+            }
+        }
+
+        buffer += '"';
+    }
+
+
+    // Appends a driving time given in seconds.  A time of an hour or more
+    // is written with its total minutes rather than the minutes past the
+    // hour, as the program always has.
+    void appendTime(std::string& buffer, double totalSeconds)
+    {
+        double minutes = totalSeconds / 60;
+        double hours = minutes / 60;
+        double seconds = (minutes - static_cast<int>(minutes)) * 60;
+
+        if (static_cast<int>(hours) != 0)
+        {
+            appendInt(buffer, static_cast<int>(hours));
+            buffer += " hrs ";
+        }
+
+        if (static_cast<int>(hours) != 0 || static_cast<int>(minutes) != 0)
+        {
+            appendInt(buffer, static_cast<int>(minutes));
+            buffer += " mins ";
+        }
+
+        appendFixed(buffer, seconds);
+        buffer += " secs";
+    }
+}
+
+
+RouteReportWriter::RouteReportWriter(std::ostream& out, ReportFormat format)
+    : out_{out}, format_{format}
+{
+}
+
+
+void RouteReportWriter::writeReports(
+    const CompactRoadGraph& graph, const std::vector<Trip>& trips,
+    const std::vector<Route>& routes, WorkStealingPool& pool)
+{
+    TraceSpan span{"write reports"};
+
+    int tripCount = static_cast<int>(trips.size());
+    int blockCount = (tripCount + tripsPerBlock - 1) / tripsPerBlock;
+    int windowSize = blocksPerWorker * static_cast<int>(pool.threadCount());
+
+    buffers_.resize(std::max(buffers_.size(), static_cast<std::size_t>(windowSize)));
+
+    for (int firstBlock = 0; firstBlock < blockCount; firstBlock += windowSize)
+    {
+        int windowBlocks = std::min(windowSize, blockCount - firstBlock);
+
+        pool.parallelFor(
+            windowBlocks,
+            [&](int index, unsigned)
+            {
+                TraceSpan blockSpan{"format reports"};
+
+                std::string& buffer = buffers_[index];
+                buffer.clear();
+
+                int begin = (firstBlock + index) * tripsPerBlock;
+                int end = std::min(begin + tripsPerBlock, tripCount);
+
+                for (int trip = begin; trip < end; ++trip)
+                {
+                    formatReport(buffer, graph, trips[trip], routes[trip]);
+                }
+            });
+
+        TraceSpan outputSpan{"write output"};
+
+        for (int index = 0; index < windowBlocks; ++index)
+        {
+            const std::string& buffer = buffers_[index];
+            out_.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        }
+    }
+}
+
+
+void RouteReportWriter::formatReport(
+    std::string& buffer, const CompactRoadGraph& graph,
+    const Trip& trip, const Route& route) const
+{
+    if (format_ == ReportFormat::JsonLines)
+    {
+        formatJsonLine(buffer, graph, trip, route);
+    }
+    else
+    {
+        formatText(buffer, graph, trip, route);
+    }
+}
+
+
+void RouteReportWriter::formatText(
+    std::string& buffer, const CompactRoadGraph& graph,
+    const Trip& trip, const Route& route) const
+{
+    if (route.empty())
+    {
+        buffer += "No route from ";
+        buffer += graph.vertexName(trip.startVertex);
+        buffer += " to ";
+        buffer += graph.vertexName(trip.endVertex);
+        buffer += "\n\n\n";
+        return;
+    }
+
+    const std::vector<RouteStop>& stops = route.stops;
+
+    buffer += trip.metric == TripMetric::Distance
+        ? "Shortest distance from " : "Shortest driving time from ";
+    buffer += stops.front().name;
+    buffer += " to ";
+    buffer += stops.back().name;
+    buffer += "\n   Begin at ";
+    buffer += stops.front().name;
+    buffer += "\n";
+
+    for (std::size_t n = 1; n < stops.size(); ++n)
+    {
+        const RoadSegment& segment = stops[n].segment;
+
+        if (trip.metric == TripMetric::Distance)
+        {
+            buffer += "   Countinue to ";
+            buffer += stops[n].name;
+            buffer += " (";
+            appendFixed(buffer, segment.miles);
+            buffer += " miles)\n";
+        }
+        else
+        {
+            buffer += "   Continue to ";
+            buffer += stops[n].name;
+            buffer += "(";
+            appendFixed(buffer, segment.miles);
+            buffer += " miles @ ";
+            appendFixed(buffer, segment.milesPerHour);
+            buffer += " mph = ";
+            appendTime(buffer, segment.miles / segment.milesPerHour * 3600);
+            buffer += ")\n";
+        }
+    }
+
+    if (trip.metric == TripMetric::Distance)
+    {
+        buffer += "Total Distance: ";
+        appendFixed(buffer, route.totalMiles());
+        buffer += " miles\n\n\n";
+    }
+    else
+    {
+        buffer += "Total time: ";
+        appendTime(buffer, route.totalSeconds());
+        buffer += "\n\n\n";
+    }
+}
+
+
+void RouteReportWriter::formatJsonLine(
+    std::string& buffer, const CompactRoadGraph& graph,
+    const Trip& trip, const Route& route) const
+{
+    buffer += "{\"start\":";
+    appendInt(buffer, trip.startVertex);
+    buffer += ",\"end\":";
+    appendInt(buffer, trip.endVertex);
+    buffer += ",\"from\":";
+    appendJsonString(buffer, graph.vertexName(trip.startVertex));
+    buffer += ",\"to\":";
+    appendJsonString(buffer, graph.vertexName(trip.endVertex));
+    buffer += trip.metric == TripMetric::Distance
+        ? ",\"metric\":\"distance\"" : ",\"metric\":\"time\"";
+
+    if (route.empty())
+    {
+        buffer += ",\"reachable\":false}\n";
+        return;
+    }
+
+    buffer += ",\"reachable\":true,\"miles\":";
+    appendJsonNumber(buffer, route.totalMiles());
+    buffer += ",\"seconds\":";
+    appendJsonNumber(buffer, route.totalSeconds());
+    buffer += ",\"stops\":[";
+
+    for (std::size_t n = 0; n < route.stops.size(); ++n)
+    {
+        const RouteStop& stop = route.stops[n];
+
+        buffer += n == 0 ? "{\"vertex\":" : ",{\"vertex\":";
+        appendInt(buffer, stop.vertex);
+        buffer += ",\"name\":";
+        appendJsonString(buffer, stop.name);
+        buffer += ",\"miles\":";
+        appendJsonNumber(buffer, stop.segment.miles);
+        buffer += ",\"mph\":";
+        appendJsonNumber(buffer, stop.segment.milesPerHour);
+        buffer += "}";
+    }
+
+    buffer += "]}\n";
+}
@@ -0,0 +1,82 @@
+// RouteReportWriter.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A RouteReportWriter is the program's output stage: it turns the Route
+// found for each trip into a report and writes the reports out in trip
+// order.  The reports are formatted straight into plain character buffers,
+// with std::to_chars for every number, rather than through an ostream's
+// formatting and locale machinery, and each buffer reaches the stream in a
+// single write.
+//
+// The trips are cut into blocks that the workers of a WorkStealingPool
+// format at the same time, one buffer per block.  The buffers keep their
+// capacity from one batch to the next, so a long run settles into writing
+// without allocating.
+//
+// ReportFormat::Text reproduces the program's standard report byte for
+// byte.  ReportFormat::JsonLines writes one object per trip:
+//
+//     {"start":0,"end":2,"from":"A","to":"C","metric":"distance",
+//      "reachable":true,"miles":1.5,"seconds":90,"stops":[{"vertex":0,
+//      "name":"A","miles":0,"mph":0},{"vertex":2,"name":"C","miles":1.5,
+//      "mph":60}]}
+//
+// (all on one line), where each stop's miles and mph describe the road
+// segment leading into it and an unreachable trip has "reachable":false
+// and no other route fields.  Numbers are written in their shortest exact
+// form; one that isn't finite is written as null.
+
+#ifndef ROUTEREPORTWRITER_HPP
+#define ROUTEREPORTWRITER_HPP
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "CompactRoadGraph.hpp"
+#include "ReportFormat.hpp"
+#include "Route.hpp"
+#include "Trip.hpp"
+#include "WorkStealingPool.hpp"
+
+
+
+class RouteReportWriter
+{
+public:
+    // Initializes a RouteReportWriter that writes reports in the given
+    // format to the given stream, which must outlive it.
+    RouteReportWriter(std::ostream& out, ReportFormat format);
+
+    // writeReports() writes the report of every trip, in order, given the
+    // Route found for each one; the names in the reports are read out of
+    // the given graph.  The reports are formatted on the given pool, and
+    // the output doesn't depend on how many threads it has.
+    void writeReports(
+        const CompactRoadGraph& graph, const std::vector<Trip>& trips,
+        const std::vector<Route>& routes, WorkStealingPool& pool);
+
+    // formatReport() appends the report of one trip to the given buffer.
+    void formatReport(
+        std::string& buffer, const CompactRoadGraph& graph,
+        const Trip& trip, const Route& route) const;
+
+private:
+    void formatText(
+        std::string& buffer, const CompactRoadGraph& graph,
+        const Trip& trip, const Route& route) const;
+
+    void formatJsonLine(
+        std::string& buffer, const CompactRoadGraph& graph,
+        const Trip& trip, const Route& route) const;
+
+private:
+    std::ostream& out_;
+    ReportFormat format_;
+    std::vector<std::string> buffers_;
+};
+
+
+
+#endif // ROUTEREPORTWRITER_HPP
@@ -0,0 +1,160 @@
+// RunOptions.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include "RunOptions.hpp"
+#include "SearchCounters.hpp"
+
+
+namespace
+{
+    // Splits an argument of the form "--name=value" into its name and
+    // value; an argument without '=' has an empty value.
+    void splitArgument(const std::string& argument, std::string& name, std::string& value)
+    {
+        std::string::size_type equals = argument.find('=');
+
+        name = argument.substr(0, equals);
+        value = equals == std::string::npos ? "" : argument.substr(equals + 1);
+    }
+
+
+    SearchEngine parseEngine(const std::string& value)
+    {
+        if (value == "dijkstra")
+        {
+            return SearchEngine::Dijkstra;
+        }
+        else if (value == "bidirectional")
+        {
+            return SearchEngine::Bidirectional;
+        }
+        else if (value == "ch")
+        {
+            return SearchEngine::ContractionHierarchies;
+        }
+        else if (value == "alt")
+        {
+            return SearchEngine::Landmarks;
+        }
+
+        throw RunOptionsException("Unknown search engine: " + value);
+    }
+
+
+    ReportFormat parseFormat(const std::string& value)
+    {
+        if (value == "text")
+        {
+            return ReportFormat::Text;
+        }
+        else if (value == "jsonl")
+        {
+            return ReportFormat::JsonLines;
+        }
+
+        throw RunOptionsException("Unknown report format: " + value);
+    }
+
+
+    MetricsFormat parseMetricsFormat(const std::string& value)
+    {
+        if (value == "json")
+        {
+            return MetricsFormat::Json;
+        }
+        else if (value == "prometheus")
+        {
+            return MetricsFormat::Prometheus;
+        }
+
+        throw RunOptionsException("Unknown metrics format: " + value);
+    }
+
+
+    unsigned parseCount(const std::string& name, const std::string& value)
+    {
+        if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos
+            || value.size() > 6)
+        {
+            throw RunOptionsException("Expected a non-negative number for " + name);
+        }
+
+        return static_cast<unsigned>(std::stoul(value));
+    }
+}
+
+
+RunOptions readRunOptions(int argc, char* argv[])
+{
+    RunOptions options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string name;
+        std::string value;
+        splitArgument(argv[i], name, value);
+
+        if (name == "--engine")
+        {
+            options.engine = parseEngine(value);
+        }
+        else if (name == "--threads")
+        {
+            options.threads = parseCount(name, value);
+        }
+        else if (name == "--landmarks")
+        {
+            options.landmarks = parseCount(name, value);
+        }
+        else if (name == "--live" && value.empty())
+        {
+            options.live = true;
+        }
+        else if (name == "--live-trees")
+        {
+            options.liveTrees = parseCount(name, value);
+        }
+        else if (name == "--input" && !value.empty())
+        {
+            options.inputFile = value;
+        }
+        else if (name == "--snapshot" && !value.empty())
+        {
+            options.snapshotFile = value;
+        }
+        else if (name == "--write-snapshot" && !value.empty())
+        {
+            options.writeSnapshotFile = value;
+        }
+        else if (name == "--format")
+        {
+            options.format = parseFormat(value);
+        }
+        else if (name == "--metrics")
+        {
+            options.metrics = parseMetricsFormat(value);
+        }
+        else if (name == "--metrics-file" && !value.empty())
+        {
+            options.metricsFile = value;
+        }
+        else if (name == "--trace" && !value.empty())
+        {
+            options.traceFile = value;
+        }
+        else
+        {
+            throw RunOptionsException("Unknown argument: " + std::string{argv[i]});
+        }
+    }
+
+    if (options.metrics != MetricsFormat::None && !searchInstrumentation)
+    {
+        throw RunOptionsException(
+            "--metrics requires a build with SEARCH_INSTRUMENTATION defined");
+    }
+
+    return options;
+}
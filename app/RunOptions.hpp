@@ -0,0 +1,95 @@
+// RunOptions.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// RunOptions collects the settings that can be given to the program on its
+// command line.  Every setting has a default that reproduces the program's
+// standard behavior, so running it with no arguments at all is fine.
+//
+// Recognized arguments:
+//
+//     --engine=dijkstra|bidirectional|ch|alt
+//                        (ch and alt preprocess the map into contraction
+//                         hierarchies or landmark distance tables first;
+//                         they're ignored with --live)
+//     --landmarks=N      (the number of landmarks that alt chooses)
+//     --threads=N        (0 means one thread per hardware thread)
+//     --live             (read a stream of trips and speed updates; see
+//                         TrafficEventReader.hpp)
+//     --live-trees=N     (the number of shortest path trees that --live
+//                         keeps between batches of trips; see
+//                         LiveRoutePlanner.hpp)
+//     --input=FILE       (map FILE into memory and parse it in place,
+//                         instead of reading the standard input)
+//     --snapshot=FILE    (load the road map from the binary snapshot FILE;
+//                         the input then holds only the trips, or the
+//                         live events)
+//     --write-snapshot=FILE
+//                        (write the road map to FILE as a binary snapshot
+//                         before answering any trips)
+//     --format=text|jsonl
+//                        (write the standard report, or one JSON object
+//                         per trip; see RouteReportWriter.hpp)
+//     --metrics=json|prometheus
+//                        (dump the SearchMetrics of the run when it ends,
+//                         and whenever the process receives SIGUSR1; only
+//                         available when built with SEARCH_INSTRUMENTATION)
+//     --metrics-file=FILE
+//                        (write each dump over FILE instead of appending
+//                         it to the standard error)
+//     --trace=FILE       (record a timeline of the run's phases and
+//                         searches, and write it to FILE in the Chrome
+//                         trace event format when the run ends; see
+//                         TraceRecorder.hpp)
+
+#ifndef RUNOPTIONS_HPP
+#define RUNOPTIONS_HPP
+
+#include <string>
+#include "MetricsFormat.hpp"
+#include "ReportFormat.hpp"
+#include "SearchEngine.hpp"
+
+
+
+// A RunOptionsException is thrown by readRunOptions() when an argument is
+// not recognized or has an invalid value.
+
+class RunOptionsException
+{
+public:
+    RunOptionsException(const std::string& reason): reason_{reason} { }
+
+    std::string reason() const { return reason_; }
+
+private:
+    std::string reason_;
+};
+
+
+
+struct RunOptions
+{
+    SearchEngine engine = SearchEngine::Dijkstra;
+    unsigned threads = 1;
+    unsigned landmarks = 16;
+    bool live = false;
+    unsigned liveTrees = 64;
+    std::string inputFile;
+    std::string snapshotFile;
+    std::string writeSnapshotFile;
+    ReportFormat format = ReportFormat::Text;
+    MetricsFormat metrics = MetricsFormat::None;
+    std::string metricsFile;
+    std::string traceFile;
+};
+
+
+
+// readRunOptions() builds a RunOptions from the arguments passed to main().
+RunOptions readRunOptions(int argc, char* argv[]);
+
+
+
+#endif // RUNOPTIONS_HPP
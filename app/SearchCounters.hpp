@@ -0,0 +1,80 @@
+// SearchCounters.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// SearchCounters tally the work one shortest path search does: how many
+// vertices it settled, how many edges it relaxed from them, how many
+// entries it pushed onto its priority queue, and how many entries it
+// popped only to find them stale (superseded by a later, shorter label).
+//
+// Counting is compiled in only when SEARCH_INSTRUMENTATION is defined
+// (e.g. with -DSEARCH_INSTRUMENTATION).  Otherwise the count functions are
+// empty and the searches compile to the same loops as without them; the
+// counters themselves stay at zero.
+
+#ifndef SEARCHCOUNTERS_HPP
+#define SEARCHCOUNTERS_HPP
+
+
+
+#ifdef SEARCH_INSTRUMENTATION
+constexpr bool searchInstrumentation = true;
+#else
+constexpr bool searchInstrumentation = false;
+#endif
+
+
+
+struct SearchCounters
+{
+    long long settled = 0;
+    long long relaxed = 0;
+    long long pushes = 0;
+    long long stalePops = 0;
+
+    void countSettled()
+    {
+        if constexpr (searchInstrumentation)
+        {
+            ++settled;
+        }
+    }
+
+    void countRelaxed()
+    {
+        if constexpr (searchInstrumentation)
+        {
+            ++relaxed;
+        }
+    }
+
+    void countPush()
+    {
+        if constexpr (searchInstrumentation)
+        {
+            ++pushes;
+        }
+    }
+
+    void countStalePop()
+    {
+        if constexpr (searchInstrumentation)
+        {
+            ++stalePops;
+        }
+    }
+
+    SearchCounters& operator+=(const SearchCounters& other)
+    {
+        settled += other.settled;
+        relaxed += other.relaxed;
+        pushes += other.pushes;
+        stalePops += other.stalePops;
+        return *this;
+    }
+};
+
+
+
+#endif // SEARCHCOUNTERS_HPP
@@ -0,0 +1,28 @@
+// SearchEngine.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A SearchEngine describes which algorithm the program uses to answer a
+// trip: a Dijkstra search from the start vertex that stops once the end
+// vertex is settled, a bidirectional Dijkstra search that also works
+// backward from the end vertex, a query against a ContractionHierarchy
+// built for the trip's TripMetric before any trip is answered, or an A*
+// search guided by a LandmarkIndex built the same way.
+
+#ifndef SEARCHENGINE_HPP
+#define SEARCHENGINE_HPP
+
+
+
+enum class SearchEngine
+{
+    Dijkstra,
+    Bidirectional,
+    ContractionHierarchies,
+    Landmarks
+};
+
+
+
+#endif // SEARCHENGINE_HPP
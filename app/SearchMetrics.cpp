@@ -0,0 +1,193 @@
+// SearchMetrics.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <charconv>
+#include <string>
+#include "SearchMetrics.hpp"
+
+
+namespace
+{
+    const char* metricNames[] = {"distance", "time"};
+
+
+    // Writes a number in its shortest exact form, so that bucket bounds
+    // like 0.000128 seconds aren't rounded by the stream's precision.
+    void writeNumber(std::ostream& out, double value)
+    {
+        char digits[64];
+        out.write(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr - digits);
+    }
+
+
+    // Describes one of the histograms kept for each TripMetric.  Running
+    // times are exported in seconds, as Prometheus expects; since they're
+    // recorded in whole microseconds, a time in bucket k is below 2^k
+    // microseconds.
+    struct HistogramDescription
+    {
+        const char* jsonName;
+        const char* prometheusName;
+        const char* help;
+        bool microseconds;
+    };
+
+
+    const HistogramDescription descriptions[] = {
+        {"settled", "trip_search_settled_vertices", "Vertices settled by each search.", false},
+        {"relaxed", "trip_search_relaxed_edges", "Edges relaxed by each search.", false},
+        {"pushes", "trip_search_heap_pushes", "Priority queue pushes made by each search.", false},
+        {"stale_pops", "trip_search_stale_pops",
+            "Stale priority queue entries popped by each search.", false},
+        {"microseconds", "trip_search_duration_seconds", "Running time of each search.", true}
+    };
+}
+
+
+SearchHistogram::SearchHistogram()
+    : count_{0}, sum_{0}
+{
+    for (std::atomic<long long>& bucket : buckets_)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+
+void SearchHistogram::record(long long value)
+{
+    int index = 0;
+
+    while (index < bucketCount - 1 && value > bucketBound(index))
+    {
+        ++index;
+    }
+
+    buckets_[index].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+}
+
+
+void SearchMetrics::recordSearch(
+    TripMetric metric, const SearchCounters& counters, std::chrono::nanoseconds elapsed)
+{
+    MetricHistograms& histograms = histograms_[metric == TripMetric::Distance ? 0 : 1];
+
+    histograms.settled.record(counters.settled);
+    histograms.relaxed.record(counters.relaxed);
+    histograms.pushes.record(counters.pushes);
+    histograms.stalePops.record(counters.stalePops);
+    histograms.microseconds.record(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
+
+
+void SearchMetrics::recordRejected(TripMetric metric)
+{
+    histograms_[metric == TripMetric::Distance ? 0 : 1].rejected.fetch_add(
+        1, std::memory_order_relaxed);
+}
+
+
+void SearchMetrics::writeJson(std::ostream& out) const
+{
+    out << "{";
+
+    for (int metric = 0; metric < 2; ++metric)
+    {
+        const MetricHistograms& histograms = histograms_[metric];
+        const SearchHistogram* all[] = {
+            &histograms.settled, &histograms.relaxed, &histograms.pushes,
+            &histograms.stalePops, &histograms.microseconds};
+
+        out << (metric == 0 ? "\"" : ",\"") << metricNames[metric] << "\":{"
+            << "\"searches\":" << histograms.settled.count()
+            << ",\"rejected\":" << histograms.rejected.load(std::memory_order_relaxed);
+
+        for (int which = 0; which < 5; ++which)
+        {
+            const SearchHistogram& histogram = *all[which];
+
+            out << ",\"" << descriptions[which].jsonName << "\":{"
+                << "\"count\":" << histogram.count()
+                << ",\"sum\":" << histogram.sum()
+                << ",\"buckets\":[";
+
+            bool first = true;
+
+            for (int index = 0; index < SearchHistogram::bucketCount; ++index)
+            {
+                if (histogram.bucket(index) != 0)
+                {
+                    out << (first ? "" : ",")
+                        << "{\"le\":" << SearchHistogram::bucketBound(index)
+                        << ",\"count\":" << histogram.bucket(index) << "}";
+                    first = false;
+                }
+            }
+
+            out << "]}";
+        }
+
+        out << "}";
+    }
+
+    out << "}\n";
+}
+
+
+void SearchMetrics::writePrometheus(std::ostream& out) const
+{
+    out << "# HELP trip_search_rejected_total Trips answered without a search.\n"
+        << "# TYPE trip_search_rejected_total counter\n";
+
+    for (int metric = 0; metric < 2; ++metric)
+    {
+        out << "trip_search_rejected_total{metric=\"" << metricNames[metric] << "\"} "
+            << histograms_[metric].rejected.load(std::memory_order_relaxed) << "\n";
+    }
+
+    for (int which = 0; which < 5; ++which)
+    {
+        const HistogramDescription& description = descriptions[which];
+        std::string name = description.prometheusName;
+        double scale = description.microseconds ? 1e-6 : 1.0;
+
+        out << "# HELP " << name << " " << description.help << "\n"
+            << "# TYPE " << name << " histogram\n";
+
+        for (int metric = 0; metric < 2; ++metric)
+        {
+            const MetricHistograms& histograms = histograms_[metric];
+            const SearchHistogram* all[] = {
+                &histograms.settled, &histograms.relaxed, &histograms.pushes,
+                &histograms.stalePops, &histograms.microseconds};
+            const SearchHistogram& histogram = *all[which];
+            std::string label = std::string{"metric=\""} + metricNames[metric] + "\"";
+
+            // Prometheus buckets are cumulative, and the last one is +Inf.
+            long long cumulative = 0;
+
+            for (int index = 0; index < SearchHistogram::bucketCount - 1; ++index)
+            {
+                cumulative += histogram.bucket(index);
+
+                double bound = description.microseconds
+                    ? static_cast<double>(SearchHistogram::bucketBound(index) + 1)
+                    : static_cast<double>(SearchHistogram::bucketBound(index));
+
+                out << name << "_bucket{" << label << ",le=\"";
+                writeNumber(out, bound * scale);
+                out << "\"} " << cumulative << "\n";
+            }
+
+            out << name << "_bucket{" << label << ",le=\"+Inf\"} " << histogram.count() << "\n";
+            out << name << "_sum{" << label << "} ";
+            writeNumber(out, static_cast<double>(histogram.sum()) * scale);
+            out << "\n" << name << "_count{" << label << "} " << histogram.count() << "\n";
+        }
+    }
+}
@@ -0,0 +1,108 @@
+// SearchMetrics.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// SearchMetrics aggregate the SearchCounters and running time of every
+// search a TripPlanner or LiveRoutePlanner runs, separately for each
+// TripMetric, into histograms whose buckets double in width: bucket k
+// holds the values from 2^(k-1) to 2^k - 1, and bucket 0 holds zero.
+// Running times are kept in whole microseconds.  It also counts the trips that were turned away
+// without a search because their end vertex can't be reached.
+//
+// A search that grows a tree shared by a group of trips is recorded once,
+// as a single search, and so is each repair of a live planner's tree.
+//
+// Every histogram is a set of atomic counters, so the workers of a pool
+// record into the same SearchMetrics without locking, and writeJson() or
+// writePrometheus() can run at any time, even while searches are being
+// recorded (each value is then exact, though the values may be from
+// slightly different moments).
+//
+// Nothing is recorded unless the program is built with
+// SEARCH_INSTRUMENTATION (see SearchCounters.hpp).
+
+#ifndef SEARCHMETRICS_HPP
+#define SEARCHMETRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include "SearchCounters.hpp"
+#include "TripMetric.hpp"
+
+
+
+class SearchHistogram
+{
+public:
+    static const int bucketCount = 40;
+
+public:
+    // The default constructor initializes an empty histogram.
+    SearchHistogram();
+
+    // record() adds one value to the histogram; a value too large for
+    // every other bucket lands in the last one.
+    void record(long long value);
+
+    // count() and sum() return the number of values recorded and their
+    // total.
+    long long count() const { return count_.load(std::memory_order_relaxed); }
+    long long sum() const { return sum_.load(std::memory_order_relaxed); }
+
+    // bucket() returns the number of values recorded in the given bucket.
+    long long bucket(int index) const { return buckets_[index].load(std::memory_order_relaxed); }
+
+    // bucketBound() returns the largest value that belongs in the given
+    // bucket, which is 2^index - 1.
+    static long long bucketBound(int index) { return (1LL << index) - 1; }
+
+private:
+    std::atomic<long long> buckets_[bucketCount];
+    std::atomic<long long> count_;
+    std::atomic<long long> sum_;
+};
+
+
+
+class SearchMetrics
+{
+public:
+    // recordSearch() records the counters and running time of one search
+    // run for a trip with the given TripMetric.
+    void recordSearch(
+        TripMetric metric, const SearchCounters& counters, std::chrono::nanoseconds elapsed);
+
+    // recordRejected() records a trip with the given TripMetric that was
+    // answered without a search.
+    void recordRejected(TripMetric metric);
+
+    // writeJson() writes every histogram as one JSON object, keyed by
+    // TripMetric ("distance" and "time"), listing only non-empty buckets
+    // with their bounds.
+    void writeJson(std::ostream& out) const;
+
+    // writePrometheus() writes every histogram in the Prometheus text
+    // exposition format, with a "metric" label naming the TripMetric.
+    void writePrometheus(std::ostream& out) const;
+
+private:
+    struct MetricHistograms
+    {
+        SearchHistogram settled;
+        SearchHistogram relaxed;
+        SearchHistogram pushes;
+        SearchHistogram stalePops;
+        SearchHistogram microseconds;
+        std::atomic<long long> rejected{0};
+    };
+
+    // The histograms for TripMetric::Distance and TripMetric::Time, in
+    // that order.
+    MetricHistograms histograms_[2];
+};
+
+
+
+#endif // SEARCHMETRICS_HPP
@@ -0,0 +1,24 @@
+// SpeedUpdate.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A SpeedUpdate reports a new speed (in miles per hour) at which traffic is
+// moving on the road segment between two locations, as a traffic feed would
+// send it.
+
+#ifndef SPEEDUPDATE_HPP
+#define SPEEDUPDATE_HPP
+
+
+
+struct SpeedUpdate
+{
+    int fromVertex;
+    int toVertex;
+    double milesPerHour;
+};
+
+
+
+#endif // SPEEDUPDATE_HPP
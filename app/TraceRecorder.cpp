@@ -0,0 +1,174 @@
+// TraceRecorder.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include "TraceRecorder.hpp"
+
+
+namespace
+{
+    std::atomic<unsigned long long> nextRecorderId{1};
+
+
+    // Each thread remembers the buffer it records into, and which recorder
+    // the buffer belongs to, so that it only needs the recorder's lock the
+    // first time it records into a new recorder.
+    struct ThreadCache
+    {
+        unsigned long long recorderId = 0;
+        void* buffer = nullptr;
+        std::string threadName;
+    };
+
+
+    thread_local ThreadCache threadCache;
+
+
+    void writeString(std::ostream& out, const std::string& s)
+    {
+        out << '"';
+
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out << '\\';
+            }
+
+            out << c;
+        }
+
+        out << '"';
+    }
+
+
+    // Writes a number of nanoseconds as microseconds, which is the unit of
+    // every timestamp in the trace.
+    void writeMicroseconds(std::ostream& out, long long nanoseconds)
+    {
+        long long fraction = nanoseconds % 1000;
+
+        out << nanoseconds / 1000 << '.'
+            << static_cast<char>('0' + fraction / 100)
+            << static_cast<char>('0' + fraction / 10 % 10)
+            << static_cast<char>('0' + fraction % 10);
+    }
+}
+
+
+std::atomic<TraceRecorder*> TraceRecorder::active_{nullptr};
+
+
+TraceRecorder::TraceRecorder(std::size_t capacity)
+    : id_{nextRecorderId++}, mask_{1}, origin_{Clock::now()},
+      creator_{std::this_thread::get_id()}
+{
+    while (mask_ < capacity)
+    {
+        mask_ *= 2;
+    }
+
+    --mask_;
+
+    active_.store(this, std::memory_order_release);
+}
+
+
+TraceRecorder::~TraceRecorder()
+{
+    active_.store(nullptr, std::memory_order_release);
+}
+
+
+void TraceRecorder::nameThread(const std::string& name)
+{
+    threadCache.threadName = name;
+}
+
+
+void TraceRecorder::record(const char* name, Clock::time_point start, Clock::time_point end)
+{
+    ThreadBuffer& buffer = threadBuffer();
+
+    // Only this thread writes to the buffer, so the count is only ever
+    // published, never contended.
+    unsigned long long recorded = buffer.recorded.load(std::memory_order_relaxed);
+
+    buffer.events[recorded & mask_] = TraceEvent{
+        name,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin_).count(),
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()};
+
+    buffer.recorded.store(recorded + 1, std::memory_order_release);
+}
+
+
+TraceRecorder::ThreadBuffer& TraceRecorder::threadBuffer()
+{
+    if (threadCache.recorderId == id_)
+    {
+        return *static_cast<ThreadBuffer*>(threadCache.buffer);
+    }
+
+    std::unique_ptr<ThreadBuffer> buffer = std::make_unique<ThreadBuffer>();
+    buffer->events.reset(new TraceEvent[mask_ + 1]);
+
+    if (!threadCache.threadName.empty())
+    {
+        buffer->threadName = threadCache.threadName;
+    }
+    else
+    {
+        buffer->threadName = std::this_thread::get_id() == creator_ ? "main" : "thread";
+    }
+
+    threadCache.recorderId = id_;
+    threadCache.buffer = buffer.get();
+
+    std::lock_guard<std::mutex> lock{mutex_};
+    buffers_.push_back(std::move(buffer));
+    return *buffers_.back();
+}
+
+
+void TraceRecorder::writeChromeTrace(std::ostream& out) const
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+
+    unsigned long long dropped = 0;
+
+    out << "{\"traceEvents\":[";
+
+    for (std::size_t thread = 0; thread < buffers_.size(); ++thread)
+    {
+        const ThreadBuffer& buffer = *buffers_[thread];
+
+        out << (thread == 0 ? "\n" : ",\n")
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+            << ",\"args\":{\"name\":";
+        writeString(out, buffer.threadName);
+        out << "}}";
+
+        unsigned long long recorded = buffer.recorded.load(std::memory_order_acquire);
+        unsigned long long kept = std::min<unsigned long long>(recorded, mask_ + 1);
+        dropped += recorded - kept;
+
+        for (unsigned long long i = recorded - kept; i < recorded; ++i)
+        {
+            const TraceEvent& event = buffer.events[i & mask_];
+
+            out << ",\n{\"name\":";
+            writeString(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread << ",\"ts\":";
+            writeMicroseconds(out, event.start);
+            out << ",\"dur\":";
+            writeMicroseconds(out, event.duration);
+            out << "}";
+        }
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":"
+        << dropped << "}}\n";
+}
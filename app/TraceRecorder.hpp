@@ -0,0 +1,148 @@
+// TraceRecorder.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A TraceRecorder collects a timeline of where a run spends its wall time,
+// which it writes out in the Chrome trace event format; the file can be
+// opened in chrome://tracing or ui.perfetto.dev, where each thread gets a
+// row of nested spans.
+//
+// The timeline is made of TraceSpans: a TraceSpan is a local variable
+// whose lifetime marks the span, so
+//
+//     {
+//         TraceSpan span{"read trips"};
+//         ...
+//     }
+//
+// records one span named "read trips" around the block.  A span's name
+// must be a string literal (or otherwise outlive the recorder), because
+// only the pointer is kept.
+//
+// Spans are recorded into whichever TraceRecorder exists at the time; when
+// there isn't one, a TraceSpan costs a single atomic load and never reads
+// the clock.  Each thread records into a ring buffer of its own, which it
+// alone writes, so recording takes no lock; once a thread's buffer is full,
+// each new span replaces the oldest one, so a long run keeps its most
+// recent events and the trace notes how many were dropped.
+//
+// writeChromeTrace() must not run while other threads are still recording,
+// e.g. it's called once the pool has finished the last of its loops.
+
+#ifndef TRACERECORDER_HPP
+#define TRACERECORDER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+
+class TraceRecorder
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // The number of spans each thread keeps by default.
+    static const std::size_t defaultCapacity = 1 << 18;
+
+public:
+    // Initializes a TraceRecorder and makes it the one that TraceSpans
+    // record into, keeping the given number of spans per thread (rounded
+    // up to a power of two).  Only one TraceRecorder may exist at a time.
+    explicit TraceRecorder(std::size_t capacity = defaultCapacity);
+
+    // The destructor stops TraceSpans from recording into the recorder.
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    // active() returns the TraceRecorder that exists, or nullptr if there
+    // isn't one.
+    static TraceRecorder* active() { return active_.load(std::memory_order_acquire); }
+
+    // nameThread() names the calling thread's row in every trace recorded
+    // from then on.  Otherwise the thread that created the recorder is
+    // named "main", and the others "thread".
+    static void nameThread(const std::string& name);
+
+    // record() records a span that ran on the calling thread.
+    void record(const char* name, Clock::time_point start, Clock::time_point end);
+
+    // writeChromeTrace() writes every span still held, with the threads'
+    // names, as a Chrome trace JSON object.
+    void writeChromeTrace(std::ostream& out) const;
+
+private:
+    struct TraceEvent
+    {
+        const char* name;
+        long long start;
+        long long duration;
+    };
+
+    // A buffer's events are left uninitialized, so that creating one
+    // doesn't stall its thread writing out every page up front.
+    struct ThreadBuffer
+    {
+        std::string threadName;
+        std::unique_ptr<TraceEvent[]> events;
+        std::atomic<unsigned long long> recorded{0};
+    };
+
+    ThreadBuffer& threadBuffer();
+
+private:
+    static std::atomic<TraceRecorder*> active_;
+
+    unsigned long long id_;
+    std::size_t mask_;
+    Clock::time_point origin_;
+    std::thread::id creator_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+
+
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char* name)
+        : name_{name}, recorder_{TraceRecorder::active()}
+    {
+        if (recorder_ != nullptr)
+        {
+            start_ = TraceRecorder::Clock::now();
+        }
+    }
+
+    ~TraceSpan()
+    {
+        if (recorder_ != nullptr)
+        {
+            recorder_->record(name_, start_, TraceRecorder::Clock::now());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;
+    TraceRecorder* recorder_;
+    TraceRecorder::Clock::time_point start_;
+};
+
+
+
+#endif // TRACERECORDER_HPP
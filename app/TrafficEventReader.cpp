@@ -0,0 +1,136 @@
+// TrafficEventReader.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <charconv>
+#include <sstream>
+#include <string>
+#include "TrafficEventReader.hpp"
+
+
+namespace
+{
+    // Parses the third field of an event that isn't a trip as a speed.
+    // A speed of 0 closes the road, but a negative speed would give its
+    // segment a negative weight, which no search can handle.
+    double parseSpeed(const char* begin, const char* end)
+    {
+        double milesPerHour;
+
+        if (!FastInputScanner::parseDouble(begin, end, milesPerHour))
+        {
+            throw InputFormatException(
+                "Expected D, T or a speed but found " + std::string(begin, end));
+        }
+
+        if (!(milesPerHour >= 0.0))
+        {
+            throw InputFormatException(
+                "Speed must be a non-negative number but found " + std::string(begin, end));
+        }
+
+        return milesPerHour;
+    }
+
+
+    // Parses a vertex field of an event read through an InputReader, with
+    // the same checks and messages as FastInputScanner::readInt().
+    int parseVertex(const std::string& field)
+    {
+        int vertex;
+        const char* end = field.data() + field.size();
+        std::from_chars_result result = std::from_chars(field.data(), end, vertex);
+
+        if (result.ec == std::errc::result_out_of_range)
+        {
+            throw InputFormatException("Integer out of range: " + field);
+        }
+        else if (result.ec != std::errc{} || result.ptr != end)
+        {
+            throw InputFormatException("Expected an integer but found " + field);
+        }
+
+        return vertex;
+    }
+}
+
+
+bool TrafficEventReader::readEvent(InputReader& in, TrafficEvent& event)
+{
+    std::string line;
+
+    if (!in.tryReadLine(line))
+    {
+        return false;
+    }
+
+    std::istringstream eventLine{line};
+
+    std::string first;
+    std::string second;
+    std::string third;
+
+    if (!(eventLine >> first >> second >> third))
+    {
+        throw InputFormatException("Missing field on line: " + line);
+    }
+
+    std::string extra;
+
+    if (eventLine >> extra)
+    {
+        throw InputFormatException("Unexpected field on line: " + line);
+    }
+
+    int fromVertex = parseVertex(first);
+    int toVertex = parseVertex(second);
+
+    if (third == "D" || third == "T")
+    {
+        event.kind = TrafficEvent::Kind::Trip;
+        event.trip = Trip{
+            fromVertex, toVertex,
+            third == "D" ? TripMetric::Distance : TripMetric::Time};
+    }
+    else
+    {
+        event.kind = TrafficEvent::Kind::SpeedUpdate;
+        event.update = SpeedUpdate{
+            fromVertex, toVertex, parseSpeed(third.data(), third.data() + third.size())};
+    }
+
+    return true;
+}
+
+
+bool TrafficEventReader::readEvent(FastInputScanner& in, TrafficEvent& event)
+{
+    if (!in.nextLine())
+    {
+        return false;
+    }
+
+    int fromVertex = in.readInt();
+    int toVertex = in.readInt();
+
+    const char* thirdBegin;
+    const char* thirdEnd;
+    in.readWord(thirdBegin, thirdEnd);
+    in.requireLineEnd();
+
+    if (thirdEnd - thirdBegin == 1 && (*thirdBegin == 'D' || *thirdBegin == 'T'))
+    {
+        event.kind = TrafficEvent::Kind::Trip;
+        event.trip = Trip{
+            fromVertex, toVertex,
+            *thirdBegin == 'D' ? TripMetric::Distance : TripMetric::Time};
+    }
+    else
+    {
+        event.kind = TrafficEvent::Kind::SpeedUpdate;
+        event.update = SpeedUpdate{fromVertex, toVertex, parseSpeed(thirdBegin, thirdEnd)};
+    }
+
+    return true;
+}
@@ -0,0 +1,64 @@
+// TrafficEventReader.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// In live mode, the part of the input that follows the road map is a
+// stream of traffic events, read until the end of the input, with one
+// event per line:
+//
+//     from to D|T          a trip, as in the trips section of the input
+//     from to newMph       a new speed for the road segment from -> to
+//
+// A new speed of 0 closes the road segment; a negative speed, or one that
+// isn't a number, is an InputFormatException, as is a line without exactly
+// three fields.  The line is consumed either way, so the next call reads
+// the event after it.
+//
+// A TrafficEventReader reads these events one at a time, so that speed
+// updates and trips can be handled in the order they arrive.
+//
+// inputs/live-sample.txt is a complete live input, with slowdowns, a
+// closure and a reopening between its trips.
+
+#ifndef TRAFFICEVENTREADER_HPP
+#define TRAFFICEVENTREADER_HPP
+
+#include "FastInputScanner.hpp"
+#include "InputReader.hpp"
+#include "SpeedUpdate.hpp"
+#include "Trip.hpp"
+
+
+
+struct TrafficEvent
+{
+    enum class Kind
+    {
+        Trip,
+        SpeedUpdate
+    };
+
+    Kind kind;
+    Trip trip;
+    SpeedUpdate update;
+};
+
+
+
+class TrafficEventReader
+{
+public:
+    // readEvent() reads the next traffic event from the given InputReader
+    // into the given TrafficEvent.  It returns false, leaving the event
+    // alone, once the input has run out.
+    bool readEvent(InputReader& in, TrafficEvent& event);
+
+    // This overload of readEvent() reads the next traffic event from a
+    // FastInputScanner instead.
+    bool readEvent(FastInputScanner& in, TrafficEvent& event);
+};
+
+
+
+#endif // TRAFFICEVENTREADER_HPP
@@ -0,0 +1,262 @@
+// TripPlanner.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <utility>
+#include "TraceRecorder.hpp"
+#include "TripPlanner.hpp"
+#include "TripWeights.hpp"
+
+
+namespace
+{
+    // Extracts the Route to the end vertex from a shortest path tree.
+    Route traceRoute(
+        const CompactRoadGraph& graph, const CompactPaths& tree, int startVertex, int endVertex)
+    {
+        if (std::isinf(tree.distances[endVertex]))
+        {
+            return Route{};
+        }
+
+        std::vector<int> edges;
+
+        for (int vertex = endVertex; vertex != startVertex; vertex = tree.predecessors[vertex])
+        {
+            edges.push_back(tree.predecessorEdges[vertex]);
+        }
+
+        std::reverse(edges.begin(), edges.end());
+        return graph.makeRoute(startVertex, edges);
+    }
+}
+
+
+TripPlanner::TripPlanner(
+    const CompactRoadGraph& graph, SearchEngine engine,
+    WorkStealingPool& pool, int landmarkCount, SearchMetrics* metrics)
+    : graph_{graph}, engine_{engine}, components_{graph}, metrics_{metrics}
+{
+    if (engine_ == SearchEngine::ContractionHierarchies)
+    {
+        hierarchies_[0] = std::make_unique<ContractionHierarchy>(
+            graph_, TripMetric::Distance, pool);
+        hierarchies_[1] = std::make_unique<ContractionHierarchy>(
+            graph_, TripMetric::Time, pool);
+    }
+    else if (engine_ == SearchEngine::Landmarks)
+    {
+        landmarks_[0] = std::make_unique<LandmarkIndex>(
+            graph_, TripMetric::Distance, landmarkCount, pool);
+        landmarks_[1] = std::make_unique<LandmarkIndex>(
+            graph_, TripMetric::Time, landmarkCount, pool);
+    }
+}
+
+
+std::vector<Route> TripPlanner::planTrips(
+    const std::vector<Trip>& trips, WorkStealingPool& pool) const
+{
+    TraceSpan span{"plan trips"};
+
+    for (const Trip& trip : trips)
+    {
+        if (!graph_.hasVertex(trip.startVertex) || !graph_.hasVertex(trip.endVertex))
+        {
+            throw DigraphException("Vertex does not exist.");
+        }
+    }
+
+    std::vector<Route> routes(trips.size());
+
+    // Each worker gets a pair of workspaces for its point-to-point
+    // searches, reused for every trip it answers.
+    std::vector<QueryWorkspace> workspaces(2 * pool.threadCount());
+
+    if (engine_ == SearchEngine::ContractionHierarchies || engine_ == SearchEngine::Landmarks)
+    {
+        pool.parallelFor(
+            static_cast<int>(trips.size()),
+            [&](int index, unsigned worker)
+            {
+                routes[index] = planTrip(
+                    trips[index], workspaces[2 * worker], workspaces[2 * worker + 1]);
+            });
+
+        return routes;
+    }
+
+    std::map<std::pair<int, TripMetric>, std::vector<int>> groupMap;
+
+    for (int i = 0; i < static_cast<int>(trips.size()); ++i)
+    {
+        // A trip that can't be completed keeps its empty route and joins
+        // no group.
+        if (!components_.mayReach(trips[i].startVertex, trips[i].endVertex))
+        {
+            recordRejected(trips[i]);
+            continue;
+        }
+
+        groupMap[std::make_pair(trips[i].startVertex, trips[i].metric)].push_back(i);
+    }
+
+    std::vector<std::vector<int>> groups;
+    groups.reserve(groupMap.size());
+
+    for (auto& group : groupMap)
+    {
+        groups.push_back(std::move(group.second));
+    }
+
+    // Each group writes only the routes of its own trips, so the workers
+    // never touch the same element of routes.
+    pool.parallelFor(
+        static_cast<int>(groups.size()),
+        [&](int index, unsigned worker)
+        {
+            const std::vector<int>& members = groups[index];
+            const Trip& first = trips[members.front()];
+
+            if (members.size() == 1)
+            {
+                routes[members.front()] = planTrip(
+                    first, workspaces[2 * worker], workspaces[2 * worker + 1]);
+                return;
+            }
+
+            TraceSpan groupSpan{"search tree"};
+
+            std::chrono::steady_clock::time_point start;
+
+            if constexpr (searchInstrumentation)
+            {
+                start = std::chrono::steady_clock::now();
+            }
+
+            CompactPaths tree = withTripWeight(
+                first.metric,
+                [&](auto weight)
+                {
+                    return graph_.findShortestPathTree(first.startVertex, weight);
+                });
+
+            if constexpr (searchInstrumentation)
+            {
+                if (metrics_ != nullptr)
+                {
+                    metrics_->recordSearch(
+                        first.metric, tree.counters, std::chrono::steady_clock::now() - start);
+                }
+            }
+
+            for (int member : members)
+            {
+                routes[member] = traceRoute(
+                    graph_, tree, first.startVertex, trips[member].endVertex);
+            }
+        });
+
+    return routes;
+}
+
+
+Route TripPlanner::planTrip(const Trip& trip) const
+{
+    QueryWorkspace forwardWorkspace;
+    QueryWorkspace backwardWorkspace;
+
+    return planTrip(trip, forwardWorkspace, backwardWorkspace);
+}
+
+
+Route TripPlanner::planTrip(
+    const Trip& trip, QueryWorkspace& forwardWorkspace, QueryWorkspace& backwardWorkspace) const
+{
+    TraceSpan span{"search"};
+
+    if (!graph_.hasVertex(trip.startVertex) || !graph_.hasVertex(trip.endVertex))
+    {
+        throw DigraphException("Vertex does not exist.");
+    }
+
+    if (!components_.mayReach(trip.startVertex, trip.endVertex))
+    {
+        recordRejected(trip);
+        return Route{};
+    }
+
+    if constexpr (searchInstrumentation)
+    {
+        if (metrics_ != nullptr)
+        {
+            // A unidirectional search never prepares the backward
+            // workspace, so its counters are cleared here.
+            forwardWorkspace.counters() = SearchCounters{};
+            backwardWorkspace.counters() = SearchCounters{};
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            Route route = searchTrip(trip, forwardWorkspace, backwardWorkspace);
+            std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+
+            SearchCounters counters = forwardWorkspace.counters();
+            counters += backwardWorkspace.counters();
+            metrics_->recordSearch(trip.metric, counters, elapsed);
+
+            return route;
+        }
+    }
+
+    return searchTrip(trip, forwardWorkspace, backwardWorkspace);
+}
+
+
+Route TripPlanner::searchTrip(
+    const Trip& trip, QueryWorkspace& forwardWorkspace, QueryWorkspace& backwardWorkspace) const
+{
+    int index = trip.metric == TripMetric::Distance ? 0 : 1;
+
+    if (engine_ == SearchEngine::ContractionHierarchies)
+    {
+        return hierarchies_[index]->findShortestPath(
+            trip.startVertex, trip.endVertex, forwardWorkspace, backwardWorkspace);
+    }
+
+    return withTripWeight(
+        trip.metric,
+        [&](auto weight)
+        {
+            if (engine_ == SearchEngine::Landmarks)
+            {
+                return graph_.findShortestPathGuided(
+                    trip.startVertex, trip.endVertex, weight,
+                    landmarks_[index]->heuristicTo(trip.endVertex), forwardWorkspace);
+            }
+            else if (engine_ == SearchEngine::Bidirectional)
+            {
+                return graph_.findShortestPathBidirectional(
+                    trip.startVertex, trip.endVertex, weight,
+                    forwardWorkspace, backwardWorkspace);
+            }
+
+            return graph_.findShortestPath(
+                trip.startVertex, trip.endVertex, weight, forwardWorkspace);
+        });
+}
+
+
+void TripPlanner::recordRejected(const Trip& trip) const
+{
+    if constexpr (searchInstrumentation)
+    {
+        if (metrics_ != nullptr)
+        {
+            metrics_->recordRejected(trip.metric);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+// TripPlanner.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A TripPlanner answers a whole batch of trips against a CompactRoadGraph.
+// Trips that share both a start vertex and a TripMetric are grouped, and
+// each group is answered from a single shortest path tree grown from the
+// shared start vertex, so a file with thousands of trips from a few dozen
+// depots needs only a few dozen searches.  A trip that is alone in its
+// group is answered with a point-to-point search using the SearchEngine
+// the planner was given.
+//
+// The groups are independent of each other, so planTrips() spreads them
+// across the workers of a WorkStealingPool; the graph is only ever read.
+//
+// With SearchEngine::ContractionHierarchies or SearchEngine::Landmarks, the
+// planner instead builds one ContractionHierarchy or LandmarkIndex per
+// TripMetric up front, and answers every trip with its own query, which is
+// cheaper than even a shared tree.
+//
+// Whatever the engine, a ComponentIndex built with the planner turns away
+// trips whose end vertex lies in a part of the map that can't be reached
+// from the start vertex, before any search is run.
+//
+// A planner given SearchMetrics records the counters and running time of
+// every search it runs into them, along with the trips it turned away
+// (see SearchMetrics.hpp).
+
+#ifndef TRIPPLANNER_HPP
+#define TRIPPLANNER_HPP
+
+#include <memory>
+#include <vector>
+#include "CompactRoadGraph.hpp"
+#include "ComponentIndex.hpp"
+#include "ContractionHierarchy.hpp"
+#include "LandmarkIndex.hpp"
+#include "QueryWorkspace.hpp"
+#include "SearchEngine.hpp"
+#include "SearchMetrics.hpp"
+#include "Trip.hpp"
+#include "WorkStealingPool.hpp"
+
+
+
+class TripPlanner
+{
+public:
+    // Initializes a TripPlanner that searches the given graph, which must
+    // outlive it.  Any preprocessing the engine needs is run on the given
+    // pool before the constructor returns; SearchEngine::Landmarks chooses
+    // the given number of landmarks.  If metrics are given, they must
+    // outlive the planner as well.
+    TripPlanner(
+        const CompactRoadGraph& graph, SearchEngine engine,
+        WorkStealingPool& pool, int landmarkCount = 16,
+        SearchMetrics* metrics = nullptr);
+
+    // planTrips() returns one Route per trip, in the same order as the
+    // given trips.  Each Route runs from the trip's start vertex to its end
+    // vertex, and is empty if the end vertex can't be reached.  If a trip
+    // names a vertex that does not exist, a DigraphException is thrown.
+    // The searches are run on the given pool; the result doesn't depend on
+    // how many threads it has.
+    std::vector<Route> planTrips(
+        const std::vector<Trip>& trips, WorkStealingPool& pool) const;
+
+    // planTrip() returns the Route for a single trip with a point-to-point
+    // search.
+    Route planTrip(const Trip& trip) const;
+
+private:
+    // This overload of planTrip() searches with the given workspaces.
+    Route planTrip(
+        const Trip& trip,
+        QueryWorkspace& forwardWorkspace, QueryWorkspace& backwardWorkspace) const;
+
+    // searchTrip() runs the point-to-point search for a trip that has
+    // already been checked, without recording it.
+    Route searchTrip(
+        const Trip& trip,
+        QueryWorkspace& forwardWorkspace, QueryWorkspace& backwardWorkspace) const;
+
+    // recordRejected() records a trip turned away by the ComponentIndex,
+    // if the planner has metrics.
+    void recordRejected(const Trip& trip) const;
+
+private:
+    const CompactRoadGraph& graph_;
+    SearchEngine engine_;
+    ComponentIndex components_;
+    SearchMetrics* metrics_;
+
+    // The hierarchies or landmark indexes for TripMetric::Distance and
+    // TripMetric::Time, in that order; only built for the engines that
+    // use them.
+    std::unique_ptr<ContractionHierarchy> hierarchies_[2];
+    std::unique_ptr<LandmarkIndex> landmarks_[2];
+};
+
+
+
+#endif // TRIPPLANNER_HPP
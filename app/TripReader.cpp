@@ -5,11 +5,14 @@
 
 #include <sstream>
 #include <string>
+#include "TraceRecorder.hpp"
 #include "TripReader.hpp"
 
 
 std::vector<Trip> TripReader::readTrips(InputReader& in)
 {
+    TraceSpan span{"read trips"};
+
     std::vector<Trip> trips;
 
     int numberOfTrips = in.readIntLine();
@@ -0,0 +1,74 @@
+// TripWeights.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// DistanceWeight and TimeWeight are the edge weight policies behind the two
+// TripMetrics.  They're plain functors, so passing one to the templated
+// search functions lets the compiler inline the weight into the relaxation
+// loop, where a std::function would cost an indirect call per edge.
+//
+// A segment whose speed is 0 is closed, as a traffic feed reports it, so
+// both policies weigh it infinitely much and no search routes a trip over
+// it.
+//
+// withTripWeight() turns a TripMetric known only at run time into a call
+// with the matching policy, e.g.
+//
+//     withTripWeight(trip.metric, [&](auto weight)
+//     {
+//         return graph.findShortestPath(trip.startVertex, trip.endVertex, weight);
+//     });
+
+#ifndef TRIPWEIGHTS_HPP
+#define TRIPWEIGHTS_HPP
+
+#include <limits>
+#include "RoadSegment.hpp"
+#include "TripMetric.hpp"
+
+
+
+struct DistanceWeight
+{
+    static constexpr TripMetric metric = TripMetric::Distance;
+
+    double operator()(const RoadSegment& segment) const
+    {
+        return segment.milesPerHour == 0.0
+            ? std::numeric_limits<double>::infinity()
+            : segment.miles;
+    }
+};
+
+
+
+struct TimeWeight
+{
+    static constexpr TripMetric metric = TripMetric::Time;
+
+    double operator()(const RoadSegment& segment) const
+    {
+        return segment.milesPerHour == 0.0
+            ? std::numeric_limits<double>::infinity()
+            : segment.miles / segment.milesPerHour;
+    }
+};
+
+
+
+template <typename Visitor>
+auto withTripWeight(TripMetric metric, Visitor visitor)
+    -> decltype(visitor(DistanceWeight{}))
+{
+    if (metric == TripMetric::Distance)
+    {
+        return visitor(DistanceWeight{});
+    }
+
+    return visitor(TimeWeight{});
+}
+
+
+
+#endif // TRIPWEIGHTS_HPP
@@ -0,0 +1,191 @@
+// WorkStealingPool.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <string>
+#include "TraceRecorder.hpp"
+#include "WorkStealingPool.hpp"
+
+
+namespace
+{
+    // The pool, if any, whose worker is running on this thread, and that
+    // worker's number.  parallelFor() checks them so that a task calling
+    // back into its own pool runs the nested loop itself, instead of
+    // waiting on workers that are all busy waiting on it.
+    thread_local const WorkStealingPool* runningPool = nullptr;
+    thread_local unsigned runningWorker = 0;
+}
+
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount)
+    : generation_{0}, stopping_{false}, task_{nullptr}, remaining_{0}
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned worker = 0; worker < threadCount; ++worker)
+    {
+        queues_.push_back(std::make_unique<TaskQueue>());
+    }
+
+    for (unsigned worker = 0; worker < threadCount; ++worker)
+    {
+        workers_.emplace_back(&WorkStealingPool::runWorker, this, worker);
+    }
+}
+
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stopping_ = true;
+    }
+
+    workAvailable_.notify_all();
+
+    for (std::thread& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+
+void WorkStealingPool::parallelFor(int count, const std::function<void(int, unsigned)>& task)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    if (runningPool == this)
+    {
+        for (int index = 0; index < count; ++index)
+        {
+            task(index, runningWorker);
+        }
+
+        return;
+    }
+
+    // The loop's state is published before any task is queued, because a
+    // worker still draining the queues from the previous loop may pick up
+    // one of the new tasks before it is woken.
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        task_ = &task;
+        failure_ = nullptr;
+        remaining_ = count;
+    }
+
+    // Tasks are dealt out round-robin, so each worker starts with its own
+    // share of the loop and only steals once that share is done.
+    for (int index = 0; index < count; ++index)
+    {
+        TaskQueue& queue = *queues_[index % queues_.size()];
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        queue.tasks.push_front(index);
+    }
+
+    std::unique_lock<std::mutex> lock{mutex_};
+    ++generation_;
+    workAvailable_.notify_all();
+
+    workDone_.wait(lock, [this] { return remaining_ == 0; });
+
+    if (failure_)
+    {
+        std::rethrow_exception(failure_);
+    }
+}
+
+
+void WorkStealingPool::runWorker(unsigned worker)
+{
+    TraceRecorder::nameThread("worker " + std::to_string(worker));
+
+    runningPool = this;
+    runningWorker = worker;
+
+    unsigned long seenGeneration = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            workAvailable_.wait(lock, [&] { return stopping_ || generation_ != seenGeneration; });
+
+            if (stopping_)
+            {
+                return;
+            }
+
+            seenGeneration = generation_;
+        }
+
+        int index;
+
+        while (takeTask(worker, index))
+        {
+            try
+            {
+                (*task_.load())(index, worker);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+
+                if (!failure_)
+                {
+                    failure_ = std::current_exception();
+                }
+            }
+
+            finishTask();
+        }
+    }
+}
+
+
+bool WorkStealingPool::takeTask(unsigned worker, int& task)
+{
+    for (unsigned i = 0; i < queues_.size(); ++i)
+    {
+        bool own = i == 0;
+        TaskQueue& queue = *queues_[(worker + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock{queue.mutex};
+
+        if (!queue.tasks.empty())
+        {
+            if (own)
+            {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void WorkStealingPool::finishTask()
+{
+    if (--remaining_ == 0)
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        workDone_.notify_all();
+    }
+}
@@ -0,0 +1,90 @@
+// WorkStealingPool.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A WorkStealingPool owns a fixed set of worker threads that execute
+// parallel loops.  Each worker has its own queue of tasks; a worker takes
+// tasks from the back of its own queue and, once that runs dry, steals
+// from the front of the other workers' queues, so uneven tasks (such as a
+// large trip group next to many single trips) still keep every core busy.
+//
+// Tasks are told which worker is running them, so callers can keep one
+// scratch object per worker and reuse it without locking.
+//
+// The pool runs one loop at a time, so parallelFor() must not be called
+// from two threads at once.  The thread that calls it only waits; it
+// doesn't run tasks itself.  A task may call parallelFor() on its own
+// pool, but the nested loop then runs on that task's worker alone, one
+// index after another, with the same worker argument.  A nested task must
+// not use that worker's scratch objects while the outer task is using
+// them.
+
+#ifndef WORKSTEALINGPOOL_HPP
+#define WORKSTEALINGPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+class WorkStealingPool
+{
+public:
+    // Starts a pool with the given number of worker threads.  A thread
+    // count of 0 means one thread per hardware thread.
+    explicit WorkStealingPool(unsigned threadCount);
+
+    // The destructor waits for the workers to finish and joins them.
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // threadCount() returns the number of worker threads in the pool.
+    unsigned threadCount() const { return static_cast<unsigned>(workers_.size()); }
+
+    // parallelFor() calls task(index, worker) once for every index in
+    // [0, count) and returns when all of the calls have finished.  The
+    // worker argument is in [0, threadCount()).  If any call throws, the
+    // first exception is rethrown here once the loop has drained.  Called
+    // from one of the pool's own workers, it runs the whole loop on that
+    // worker instead.
+    void parallelFor(int count, const std::function<void(int, unsigned)>& task);
+
+private:
+    struct TaskQueue
+    {
+        std::mutex mutex;
+        std::deque<int> tasks;
+    };
+
+    void runWorker(unsigned worker);
+    bool takeTask(unsigned worker, int& task);
+    void finishTask();
+
+private:
+    std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<TaskQueue>> queues_;
+
+    std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable workDone_;
+    unsigned long generation_;
+    bool stopping_;
+
+    std::atomic<const std::function<void(int, unsigned)>*> task_;
+    std::atomic<int> remaining_;
+    std::exception_ptr failure_;
+};
+
+
+
+#endif // WORKSTEALINGPOOL_HPP
@@ -11,146 +11,288 @@
 #include "TripReader.hpp"
 #include "RoadMapWriter.hpp"
 #include "RoadMap.hpp"
+#include "CompactRoadGraph.hpp"
+#include "RunOptions.hpp"
+#include "TripPlanner.hpp"
+#include "LiveRoutePlanner.hpp"
+#include "TrafficEventReader.hpp"
+#include "MappedFile.hpp"
+#include "FastInputScanner.hpp"
+#include "FastRoadMapLoader.hpp"
+#include "RoadMapSnapshotReader.hpp"
+#include "RouteReportWriter.hpp"
+#include "SearchMetrics.hpp"
+#include "MetricsSignalWatcher.hpp"
+#include "TraceRecorder.hpp"
+#include <fstream>
 #include <iostream> 
-#include <iomanip> 
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 
 
-void show_time(double total_time)
+// run_live() answers a stream of trips and speed updates.  Consecutive
+// trips are answered together, and consecutive updates are applied as one
+// batch just before the next trip that follows them.  An event that can't
+// be read, such as a malformed line or a negative speed, or that names a
+// location or road segment that isn't on the map, is reported on std::cerr
+// and skipped, so that one bad event doesn't end a long-running session.
+template <typename EventInput>
+void run_live(const RunOptions& options, EventInput& in, CompactRoadGraph& FrozenGraph, WorkStealingPool& pool,
+	RouteReportWriter& writer, SearchMetrics* metrics)
 {
-	double hours=0; 
-	double minutes=0; 
-	double seconds=0; 
-	minutes=total_time/60; 
-	hours=minutes/60; 
-	seconds=(minutes-static_cast<int>(minutes))*60; 
-	if(static_cast<int>(hours)==0&&static_cast<int>(minutes)!=0)
+	LiveRoutePlanner planner(FrozenGraph,pool,options.liveTrees,metrics);
+	TrafficEventReader eventreader;
+	TrafficEvent event;
+	std::vector<Trip> trips;
+	std::vector<SpeedUpdate> updates;
+
+	while(true)
 	{
-		std::cout<<static_cast<int>(minutes)<<" mins "<<std::setprecision(2)<<std::fixed<<seconds<<" secs";
+		try
+		{
+			if(!eventreader.readEvent(in,event))
+			{
+				break;
+			}
+		}
+		catch(InputFormatException& e)
+		{
+			std::cerr<<"Skipping event: "<<e.reason()<<"\n";
+			continue;
+		}
+
+		if(event.kind==TrafficEvent::Kind::Trip)
+		{
+			if(!FrozenGraph.hasVertex(event.trip.startVertex)||!FrozenGraph.hasVertex(event.trip.endVertex))
+			{
+				std::cerr<<"Skipping trip "<<event.trip.startVertex<<" "<<event.trip.endVertex
+					<<": Vertex does not exist.\n";
+				continue;
+			}
+			if(!updates.empty())
+			{
+				planner.applySpeedUpdates(updates);
+				updates.clear();
+			}
+			trips.push_back(event.trip);
+		}
+		else
+		{
+			if(FrozenGraph.findEdge(event.update.fromVertex,event.update.toVertex)<0)
+			{
+				std::cerr<<"Skipping speed update "<<event.update.fromVertex<<" "<<event.update.toVertex
+					<<": Edge does not exist.\n";
+				continue;
+			}
+			if(!trips.empty())
+			{
+				writer.writeReports(FrozenGraph,trips,planner.planTrips(trips),pool);
+				trips.clear();
+			}
+			updates.push_back(event.update);
+		}
 	}
-	else if(static_cast<int>(hours)==0&&static_cast<int>(minutes)==0)
+
+	writer.writeReports(FrozenGraph,trips,planner.planTrips(trips),pool);
+}
+
+
+void run_trips(const RunOptions& options, const CompactRoadGraph& FrozenGraph, WorkStealingPool& pool,
+	const std::vector<Trip>& trips, RouteReportWriter& writer, SearchMetrics* metrics)
+{
+	TripPlanner planner(FrozenGraph,options.engine,pool,options.landmarks,metrics);
+	writer.writeReports(FrozenGraph,trips,planner.planTrips(trips,pool),pool);
+}
+
+
+// load_graph() reads the road map from the snapshot named in the options
+// if there is one, or otherwise with read_text_graph(), and then writes
+// the snapshot asked for by the options, if any.
+template <typename ReadTextGraph>
+CompactRoadGraph load_graph(const RunOptions& options, ReadTextGraph read_text_graph)
+{
+	CompactRoadGraph FrozenGraph;
+	if(!options.snapshotFile.empty())
 	{
-		std::cout<<seconds<<" secs";
+		RoadMapSnapshotReader snapshotreader;
+		FrozenGraph=snapshotreader.readSnapshot(options.snapshotFile);
 	}
 	else
 	{
-		std::cout<<static_cast<int>(hours)<<" hrs "<<static_cast<int>(minutes)<<" mins "<<std::setprecision(2)<<std::fixed
-		<<seconds<<" secs";
+		FrozenGraph=read_text_graph();
 	}
 
+	if(!options.writeSnapshotFile.empty())
+	{
+		std::ofstream snapshot(options.writeSnapshotFile,std::ios::binary);
+		RoadMapWriter roadmapwriter;
+		roadmapwriter.writeSnapshot(snapshot,FrozenGraph);
+	}
+
+	return FrozenGraph;
 }
-	double get_distance(RoadSegment Road)
+
+
+// run_from_stream() reads the input from std::cin through an InputReader.
+void run_from_stream(const RunOptions& options, WorkStealingPool& pool, RouteReportWriter& writer,
+	SearchMetrics* metrics)
+{
+	InputReader ir(std::cin);
+	CompactRoadGraph FrozenGraph=load_graph(options,[&]()
 	{
-		return Road.miles; 
+		// The RoadMap only lives until it's frozen, so it's built in an
+		// arena that's released all at once when this returns.
+		std::pmr::monotonic_buffer_resource arena;
+		RoadMapReader roadreader; 
+		RoadMap Graph=roadreader.readRoadMap(ir,&arena);
+
+		/*RoadMapWriter roadmapwriter;
+		roadmapwriter.writeRoadMap(std::cout,Graph);*/
+
+		return freeze(Graph);
+	});
+
+	if(options.live)
+	{
+		run_live(options,ir,FrozenGraph,pool,writer,metrics);
+		return;
 	}
 
-	std::function<double(const RoadSegment&)> shortest_path=get_distance;
+	TripReader tripreader;
+	std::vector<Trip> trips = tripreader.readTrips(ir); 
+	run_trips(options,FrozenGraph,pool,trips,writer,metrics);
+}
+
+
+// run_from_file() maps the input file into memory and scans it in place.
+void run_from_file(const RunOptions& options, WorkStealingPool& pool, RouteReportWriter& writer,
+	SearchMetrics* metrics)
+{
+	MappedFile file(options.inputFile);
+	FastInputScanner scanner(file.data(),file.data()+file.size());
+	FastRoadMapLoader loader;
+	CompactRoadGraph FrozenGraph=load_graph(options,[&]()
+	{
+		return loader.readRoadMap(scanner);
+	});
 
-	double get_time(RoadSegment Road)
+	if(options.live)
 	{
-		return Road.miles/Road.milesPerHour; 
+		run_live(options,scanner,FrozenGraph,pool,writer,metrics);
+		return;
 	}
 
-	std::function<double(const RoadSegment&)> shortest_time=get_time; 
+	std::vector<Trip> trips=loader.readTrips(scanner);
+	run_trips(options,FrozenGraph,pool,trips,writer,metrics);
+}
+
 
-struct records
+// dump_metrics() writes the metrics in the format asked for by the options,
+// over the metrics file if there is one, or to std::cerr otherwise.
+void dump_metrics(const RunOptions& options, const SearchMetrics& metrics)
 {
-	int vertex; 
-	std::string location; 
-	RoadSegment info;
-};
+	std::ofstream file;
+	if(!options.metricsFile.empty())
+	{
+		file.open(options.metricsFile,std::ios::trunc);
+	}
+	std::ostream& out=options.metricsFile.empty()?std::cerr:file;
+
+	if(options.metrics==MetricsFormat::Json)
+	{
+		metrics.writeJson(out);
+	}
+	else
+	{
+		metrics.writePrometheus(out);
+	}
+	out.flush();
+}
 
 	
-int main()
+int main(int argc, char* argv[])
 {	
-	
-	InputReader ir(std::cin);
-	RoadMap Graph;
-	RoadMapReader roadreader; 
-	Graph=roadreader.readRoadMap(ir);
+	RunOptions options;
+	try
+	{
+		options=readRunOptions(argc,argv);
+	}
+	catch(RunOptionsException& e)
+	{
+		std::cerr<<e.reason()<<"\n";
+		return 1;
+	}
 
-	/*RoadMapWriter roadmapwriter;
-	roadmapwriter.writeRoadMap(std::cout,Graph);*/
-	
-	TripReader tripreader;
-	std::vector<Trip> trips = tripreader.readTrips(ir); 
+	// The signal watcher has to be started before the pool, so that the
+	// workers inherit its signal mask.  A dump can come from the watcher
+	// while the run is still going, so dumps are taken one at a time.
+	SearchMetrics metrics;
+	SearchMetrics* recordedmetrics=nullptr;
+	std::mutex dumpmutex;
+	std::unique_ptr<MetricsSignalWatcher> watcher;
+	if(options.metrics!=MetricsFormat::None)
+	{
+		recordedmetrics=&metrics;
+		watcher=std::make_unique<MetricsSignalWatcher>([&]()
+		{
+			std::lock_guard<std::mutex> lock(dumpmutex);
+			dump_metrics(options,metrics);
+		});
+	}
+
+	std::unique_ptr<TraceRecorder> tracer;
+	if(!options.traceFile.empty())
+	{
+		tracer=std::make_unique<TraceRecorder>();
+	}
 
+	WorkStealingPool pool(options.threads);
+	RouteReportWriter writer(std::cout,options.format);
 
-	std::map<int,int> route; 
-	for(auto single_trip:trips)
+	try
 	{
-		std::vector<records> target_trip; 
-		if(single_trip.metric==TripMetric::Distance)
+		if(options.inputFile.empty())
 		{
-			route=Graph.findShortestPaths(single_trip.startVertex,shortest_path);
-			int destination=single_trip.endVertex; 
-			records dest;
-			dest.vertex=destination; 
-			dest.location=Graph.vertexInfo(destination);
-			dest.info=Graph.edgeInfo(route[destination],destination);
-			target_trip.push_back(dest);
-			while(single_trip.startVertex!=destination)
-			{
-				int next_stop=destination;
-				destination=route[destination];
-				records trip_record; 
-				trip_record.vertex=destination;
-				trip_record.location=Graph.vertexInfo(destination);
-				trip_record.info=Graph.edgeInfo(destination,next_stop);
-				target_trip.push_back(trip_record);
-			}
-			std::cout<<"Shortest distance from "<<Graph.vertexInfo(target_trip.back().vertex)<<" to "
-			<<Graph.vertexInfo(target_trip.front().vertex)<<"\n   Begin at "<<target_trip.back().location<<"\n";
-			double distance=0.0;
-			for(int n=target_trip.size()-2;n>-1; --n)
-			{
-				std::cout<<"   Countinue to "<<target_trip[n].location<<" ("<<std::setprecision(2)<<std::fixed<<target_trip[n+1].info.miles<< " miles)\n";
-				distance+=target_trip[n+1].info.miles; 
-
-			}
-			std::cout<<"Total Distance: "<<std::setprecision(2)<<std::fixed<<distance<<" miles\n\n\n";
+			run_from_stream(options,pool,writer,recordedmetrics);
 		}
 		else
 		{
-			route=Graph.findShortestPaths(single_trip.startVertex,shortest_time);
-			int destination=single_trip.endVertex; 
-			records dest;
-			dest.vertex=destination; 
-			dest.location=Graph.vertexInfo(destination);
-			dest.info=Graph.edgeInfo(route[destination],destination);
-			target_trip.push_back(dest);
-			 
-			while(single_trip.startVertex!=destination)
-			{
-				int next_stop=destination;
-				destination=route[destination];
-				records trip_record; 
-				trip_record.vertex=destination;
-				trip_record.location=Graph.vertexInfo(destination);
-				trip_record.info=Graph.edgeInfo(destination,next_stop);
-				target_trip.push_back(trip_record);
-			}
-
-			std::cout<<"Shortest driving time from "<<Graph.vertexInfo(target_trip.back().vertex)
-			<<" to "<<Graph.vertexInfo(target_trip.front().vertex)<<"\n";
-			std::cout<<"   Begin at "<< target_trip.back().location<<"\n";
-			double time =0.0;
-			for(int n=target_trip.size()-2; n>-1; --n)
-			{
-				double time_in_hour=(target_trip[n+1].info.miles/target_trip[n+1].info.milesPerHour);
-				double time_in_second=time_in_hour*3600; 
-				std::cout<<"   Continue to "<<target_trip[n].location<< "("<<std::setprecision(2)<<std::fixed<<target_trip[n+1].info.miles<<
-				" miles @ "<<target_trip[n+1].info.milesPerHour<<" mph"<<" = ";
-				show_time(time_in_second);
-				std::cout<<")\n"; 
-				time+=time_in_second;
-			}
-			std::cout<<"Total time: ";
-			show_time(time);
-			std::cout<<"\n\n\n";
-
+			run_from_file(options,pool,writer,recordedmetrics);
 		}
+	}
+	catch(MappedFileException& e)
+	{
+		std::cerr<<e.reason()<<"\n";
+		return 1;
+	}
+	catch(InputFormatException& e)
+	{
+		std::cerr<<e.reason()<<"\n";
+		return 1;
+	}
+	catch(SnapshotException& e)
+	{
+		std::cerr<<e.reason()<<"\n";
+		return 1;
+	}
+	catch(DigraphException& e)
+	{
+		std::cerr<<e.reason()<<"\n";
+		return 1;
+	}
+
+	if(recordedmetrics!=nullptr)
+	{
+		std::lock_guard<std::mutex> lock(dumpmutex);
+		dump_metrics(options,metrics);
+	}
 
+	// Every loop on the pool has finished, so no thread is still recording.
+	if(tracer)
+	{
+		std::ofstream trace(options.traceFile);
+		tracer->writeChromeTrace(trace);
 	}
     return 0;
 }
-
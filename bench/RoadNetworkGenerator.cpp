@@ -0,0 +1,317 @@
+// RoadNetworkGenerator.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <charconv>
+#include <random>
+#include <string>
+#include <string_view>
+#include "RoadNetworkGenerator.hpp"
+
+
+namespace
+{
+    // The first avenue is numbered like the sample's, so the smallest
+    // maps read just like it.
+    const int firstAvenue = 101;
+
+
+    // The output is gathered into a buffer and handed to the stream in
+    // chunks of about this many characters.
+    const std::size_t chunkSize = 1 << 20;
+
+
+    // A RandomStream draws numbers from a std::mt19937_64 with plain
+    // arithmetic, so they're the same with every standard library.
+    class RandomStream
+    {
+    public:
+        explicit RandomStream(std::uint64_t seed): engine_{seed} { }
+
+        // uniform() returns a number in [low, high).
+        double uniform(double low, double high)
+        {
+            return low + (high - low) * (static_cast<double>(engine_() >> 11) * 0x1.0p-53);
+        }
+
+        // below() returns an integer in [0, count).
+        int below(int count)
+        {
+            return static_cast<int>(engine_() % static_cast<std::uint64_t>(count));
+        }
+
+    private:
+        std::mt19937_64 engine_;
+    };
+
+
+    // A ChunkedOutput collects text and writes it to a stream in large
+    // chunks.
+    class ChunkedOutput
+    {
+    public:
+        explicit ChunkedOutput(std::ostream& out): out_{out} { buffer_.reserve(chunkSize + 256); }
+
+        ~ChunkedOutput() { flush(); }
+
+        ChunkedOutput& operator<<(std::string_view text)
+        {
+            buffer_ += text;
+            return spill();
+        }
+
+        ChunkedOutput& operator<<(long long value)
+        {
+            char digits[24];
+            buffer_.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+            return spill();
+        }
+
+        // fixed() writes the value with the given number of digits after
+        // the decimal point.
+        ChunkedOutput& fixed(double value, int precision)
+        {
+            char digits[64];
+            buffer_.append(
+                digits,
+                std::to_chars(
+                    digits, digits + sizeof(digits), value,
+                    std::chars_format::fixed, precision).ptr);
+            return spill();
+        }
+
+        void flush()
+        {
+            out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            buffer_.clear();
+        }
+
+    private:
+        ChunkedOutput& spill()
+        {
+            if (buffer_.size() >= chunkSize)
+            {
+                flush();
+            }
+
+            return *this;
+        }
+
+    private:
+        std::ostream& out_;
+        std::string buffer_;
+    };
+
+
+    // Writes 1 as "1st", 12 as "12th", 103 as "103rd", and so on.
+    void writeOrdinal(ChunkedOutput& out, int number)
+    {
+        const char* suffix = "th";
+
+        if (number % 100 < 11 || number % 100 > 13)
+        {
+            switch (number % 10)
+            {
+            case 1: suffix = "st"; break;
+            case 2: suffix = "nd"; break;
+            case 3: suffix = "rd"; break;
+            }
+        }
+
+        out << number << suffix;
+    }
+
+
+    // Writes one road segment, with its length rounded to hundredths of a
+    // mile and its speed to tenths of a mile per hour, as in the sample.
+    void writeSegment(ChunkedOutput& out, int from, int to, double miles, double milesPerHour)
+    {
+        out << from << " " << to << " ";
+        out.fixed(miles, 2) << " ";
+        out.fixed(milesPerHour, 1) << "\n";
+    }
+
+
+    // Writes a pair of segments joining two locations in both directions,
+    // the same length both ways but each with its own speed.
+    void writeTwoWay(
+        ChunkedOutput& out, RandomStream& random, int a, int b,
+        double shortest, double longest, double slowest, double fastest)
+    {
+        double miles = random.uniform(shortest, longest);
+        double forward = random.uniform(slowest, fastest);
+        double backward = random.uniform(slowest, fastest);
+
+        writeSegment(out, a, b, miles, forward);
+        writeSegment(out, b, a, miles, backward);
+    }
+}
+
+
+RoadNetworkGenerator::RoadNetworkGenerator(const RoadNetworkShape& shape)
+    : shape_{shape}, size_{2}, corridors_{1}
+{
+    // Grow the grid while the next size still fits within the target.
+    for (;;)
+    {
+        long long next = size_ + 1;
+        long long corridors = std::max(1LL, next / shape_.freewaySpacing);
+
+        if (next * next + 2 * corridors * next > shape_.vertexTarget)
+        {
+            break;
+        }
+
+        size_ = static_cast<int>(next);
+        corridors_ = static_cast<int>(corridors);
+    }
+}
+
+
+int RoadNetworkGenerator::vertexCount() const
+{
+    return size_ * size_ + 2 * corridors_ * size_;
+}
+
+
+long long RoadNetworkGenerator::edgeCount() const
+{
+    long long blocks = 2LL * size_ * (size_ - 1);
+    long long rampAvenues = (size_ - 1) / shape_.rampSpacing + 1;
+
+    return 2 * blocks + 2LL * corridors_ * (size_ - 1) + 4 * corridors_ * rampAvenues;
+}
+
+
+void RoadNetworkGenerator::writeRoadMap(std::ostream& stream) const
+{
+    ChunkedOutput out{stream};
+    RandomStream random{shape_.seed};
+
+    out << "# LOCATIONS\n\n# number of locations\n" << vertexCount() << "\n\n# intersections\n";
+
+    for (int street = 0; street < size_; ++street)
+    {
+        for (int avenue = 0; avenue < size_; ++avenue)
+        {
+            writeOrdinal(out, street + 1);
+            out << " St & ";
+            writeOrdinal(out, firstAvenue + avenue);
+            out << " Ave\n";
+        }
+    }
+
+    for (int corridor = 0; corridor < corridors_; ++corridor)
+    {
+        for (const char* direction : {"North", "South"})
+        {
+            out << "\n# Freeway " << corridor + 1 << " " << direction << " locations\n";
+
+            for (int avenue = 0; avenue < size_; ++avenue)
+            {
+                out << "Freeway " << corridor + 1 << " " << direction << " @ ";
+                writeOrdinal(out, firstAvenue + avenue);
+                out << " Ave\n";
+            }
+        }
+    }
+
+    out << "\n\n# ROAD SEGMENTS\n\n# number of road segments\n" << edgeCount() << "\n\n# streets\n";
+
+    for (int street = 0; street < size_; ++street)
+    {
+        for (int avenue = 0; avenue + 1 < size_; ++avenue)
+        {
+            writeTwoWay(
+                out, random, intersection(street, avenue), intersection(street, avenue + 1),
+                1.2, 2.2, 24.0, 36.0);
+        }
+    }
+
+    out << "\n# avenues\n";
+
+    for (int avenue = 0; avenue < size_; ++avenue)
+    {
+        for (int street = 0; street + 1 < size_; ++street)
+        {
+            writeTwoWay(
+                out, random, intersection(street, avenue), intersection(street + 1, avenue),
+                2.0, 2.6, 30.0, 43.0);
+        }
+    }
+
+    for (int corridor = 0; corridor < corridors_; ++corridor)
+    {
+        out << "\n# Freeway " << corridor + 1 << "\n";
+
+        for (int avenue = 0; avenue + 1 < size_; ++avenue)
+        {
+            for (bool north : {true, false})
+            {
+                // The draws are made one statement at a time, since the
+                // order in which arguments are evaluated is unspecified.
+                double miles = random.uniform(2.5, 3.3);
+                double milesPerHour = random.uniform(55.0, 65.0);
+
+                writeSegment(
+                    out, freewayLocation(corridor, north, north ? avenue + 1 : avenue),
+                    freewayLocation(corridor, north, north ? avenue : avenue + 1),
+                    miles, milesPerHour);
+            }
+        }
+
+        out << "\n# Freeway " << corridor + 1 << " on and off ramps\n";
+
+        for (int avenue = 0; avenue < size_; avenue += shape_.rampSpacing)
+        {
+            int street = intersection(corridorStreet(corridor), avenue);
+
+            writeTwoWay(
+                out, random, street, freewayLocation(corridor, true, avenue),
+                0.05, 0.10, 35.0, 42.0);
+            writeTwoWay(
+                out, random, street, freewayLocation(corridor, false, avenue),
+                0.05, 0.10, 35.0, 42.0);
+        }
+    }
+
+    out << "\n\n";
+}
+
+
+void RoadNetworkGenerator::writeTrips(std::ostream& stream) const
+{
+    ChunkedOutput out{stream};
+    RandomStream random{shape_.seed ^ 0x9e3779b97f4a7c15ULL};
+
+    out << "# TRIPS\n\n# number of trips to analyze\n" << shape_.tripCount << "\n\n# the trips\n";
+
+    for (int trip = 0; trip < shape_.tripCount; ++trip)
+    {
+        int start = random.below(vertexCount());
+        int end = random.below(vertexCount());
+        bool distance = random.uniform(0.0, 1.0) < shape_.distanceFraction;
+
+        out << start << " " << end << (distance ? " D\n" : " T\n");
+    }
+}
+
+
+int RoadNetworkGenerator::intersection(int street, int avenue) const
+{
+    return street * size_ + avenue;
+}
+
+
+int RoadNetworkGenerator::freewayLocation(int corridor, bool north, int avenue) const
+{
+    return size_ * size_ + (2 * corridor + (north ? 0 : 1)) * size_ + avenue;
+}
+
+
+int RoadNetworkGenerator::corridorStreet(int corridor) const
+{
+    return std::min(size_ - 1, corridor * shape_.freewaySpacing + shape_.freewaySpacing / 2);
+}
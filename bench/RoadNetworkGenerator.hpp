@@ -0,0 +1,96 @@
+// RoadNetworkGenerator.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// A RoadNetworkGenerator writes synthetic road maps and trips in the same
+// text format as inputs/sample.txt, at any scale from a few hundred
+// locations to tens of millions, so that the program can be measured on
+// inputs far larger than the sample.
+//
+// The maps copy the structure of the sample:
+//
+//   * A grid of streets and avenues, with an intersection named like
+//     "3rd St & 104th Ave" wherever they cross.  Every block is a pair of
+//     road segments, one in each direction, of the same length but with
+//     their own city speeds.
+//   * Freeway corridors running alongside every few streets, made of a
+//     "North" freeway that runs toward lower-numbered avenues and a
+//     "South" freeway that runs the other way, with locations like
+//     "Freeway 2 North @ 104th Ave" and much higher speeds.
+//   * On and off ramps, short and slow, joining each freeway to the street
+//     beside it at every few avenues.
+//
+// Vertices are numbered street by street and then freeway by freeway, so
+// nothing needs to be kept in memory: the map is written out as it's
+// generated, which is what lets a ten-million-location map be written in
+// constant space.
+//
+// Every random choice comes from a std::mt19937_64, whose output the C++
+// standard pins down, turned into numbers with plain arithmetic rather than
+// the standard distributions (whose output varies between libraries), so a
+// given RoadNetworkShape always produces the same bytes.  The trips are
+// drawn from their own stream, so they don't depend on whether the map was
+// written too.
+
+#ifndef ROADNETWORKGENERATOR_HPP
+#define ROADNETWORKGENERATOR_HPP
+
+#include <cstdint>
+#include <ostream>
+
+
+
+// A RoadNetworkShape describes the map and trips to generate.  The grid is
+// square, and as large as it can be without the map having more than
+// vertexTarget locations (though never smaller than 2 by 2).
+
+struct RoadNetworkShape
+{
+    long long vertexTarget = 1000;
+    int freewaySpacing = 10;
+    int rampSpacing = 3;
+    int tripCount = 1000;
+    double distanceFraction = 0.5;
+    std::uint64_t seed = 1;
+};
+
+
+
+class RoadNetworkGenerator
+{
+public:
+    // Lays out a map of the given shape, whose spacings must be at least 1
+    // and whose distanceFraction must be in [0, 1].
+    explicit RoadNetworkGenerator(const RoadNetworkShape& shape);
+
+    // vertexCount() and edgeCount() return the size of the map that
+    // writeRoadMap() writes.
+    int vertexCount() const;
+    long long edgeCount() const;
+
+    // writeRoadMap() writes the LOCATIONS and ROAD SEGMENTS sections.
+    void writeRoadMap(std::ostream& out) const;
+
+    // writeTrips() writes the TRIPS section: trips between uniformly
+    // chosen locations, each asking for the shortest distance with
+    // probability distanceFraction and the shortest driving time otherwise.
+    void writeTrips(std::ostream& out) const;
+
+private:
+    // The vertex numbers of an intersection and of a freeway location.
+    int intersection(int street, int avenue) const;
+    int freewayLocation(int corridor, bool north, int avenue) const;
+
+    // The street that a freeway corridor runs alongside.
+    int corridorStreet(int corridor) const;
+
+private:
+    RoadNetworkShape shape_;
+    int size_;
+    int corridors_;
+};
+
+
+
+#endif // ROADNETWORKGENERATOR_HPP
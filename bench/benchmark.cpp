@@ -0,0 +1,330 @@
+// benchmark.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// This is the main() function of the benchmark harness, a separate program
+// that loads an input file (such as one written by the generator in
+// generate.cpp) and measures every stage the program goes through with it:
+//
+//   * parsing the map with RoadMapReader and freezing the RoadMap;
+//   * loading the map with the memory-mapped FastRoadMapLoader instead;
+//   * and, for each search engine, its preprocessing, the latency of each
+//     single trip (as percentiles), and the time to answer the whole batch
+//     of trips on the thread pool.
+//
+// After each stage it reports the process's peak resident set size so far.
+// The peak never goes down, so to see what one engine needs on its own,
+// run the harness with only that engine.
+//
+// Build it from the top of the repository with:
+//
+//     g++ -std=c++17 -O2 -pthread -Icore -Iapp -o benchmark
+//         bench/benchmark.cpp $(ls app/*.cpp | grep -v main.cpp)
+//
+// (all on one line)
+//
+// and run it as "benchmark FILE [arguments]".  Recognized arguments:
+//
+//     --engines=E,E,...  (any of dijkstra, bidirectional, ch and alt;
+//                         default all of them)
+//     --threads=N        (threads for preprocessing and batches; default 1)
+//     --queries=N        (time only the first N trips one at a time, which
+//                         keeps the slower engines quick on large maps;
+//                         default all of them)
+//     --skip-text        (don't parse the map with RoadMapReader, which is
+//                         slow and memory-hungry on the largest maps)
+
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "CompactRoadGraph.hpp"
+#include "FastInputScanner.hpp"
+#include "FastRoadMapLoader.hpp"
+#include "InputReader.hpp"
+#include "MappedFile.hpp"
+#include "RoadMapReader.hpp"
+#include "TripPlanner.hpp"
+#include "WorkStealingPool.hpp"
+
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+
+    struct BenchmarkOptions
+    {
+        std::string inputFile;
+        std::vector<std::string> engines{"dijkstra", "bidirectional", "ch", "alt"};
+        unsigned threads = 1;
+        long long queries = -1;
+        bool skipText = false;
+    };
+
+
+    class BenchmarkOptionsException
+    {
+    public:
+        BenchmarkOptionsException(const std::string& reason): reason_{reason} { }
+
+        std::string reason() const { return reason_; }
+
+    private:
+        std::string reason_;
+    };
+
+
+    SearchEngine parseEngine(const std::string& name)
+    {
+        if (name == "dijkstra")
+        {
+            return SearchEngine::Dijkstra;
+        }
+        else if (name == "bidirectional")
+        {
+            return SearchEngine::Bidirectional;
+        }
+        else if (name == "ch")
+        {
+            return SearchEngine::ContractionHierarchies;
+        }
+        else if (name == "alt")
+        {
+            return SearchEngine::Landmarks;
+        }
+
+        throw BenchmarkOptionsException("Unknown search engine: " + name);
+    }
+
+
+    long long parseCount(const std::string& name, const std::string& value)
+    {
+        if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos
+            || value.size() > 12)
+        {
+            throw BenchmarkOptionsException("Expected a non-negative number for " + name);
+        }
+
+        return std::stoll(value);
+    }
+
+
+    BenchmarkOptions readBenchmarkOptions(int argc, char* argv[])
+    {
+        BenchmarkOptions options;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument = argv[i];
+            std::string::size_type equals = argument.find('=');
+            std::string name = argument.substr(0, equals);
+            std::string value = equals == std::string::npos ? "" : argument.substr(equals + 1);
+
+            if (name == "--engines")
+            {
+                options.engines.clear();
+                std::istringstream names{value};
+                std::string engine;
+
+                while (std::getline(names, engine, ','))
+                {
+                    parseEngine(engine);
+                    options.engines.push_back(engine);
+                }
+            }
+            else if (name == "--threads")
+            {
+                options.threads = static_cast<unsigned>(parseCount(name, value));
+            }
+            else if (name == "--queries")
+            {
+                options.queries = parseCount(name, value);
+            }
+            else if (name == "--skip-text" && value.empty())
+            {
+                options.skipText = true;
+            }
+            else if (argument.compare(0, 2, "--") != 0 && options.inputFile.empty())
+            {
+                options.inputFile = argument;
+            }
+            else
+            {
+                throw BenchmarkOptionsException("Unknown argument: " + argument);
+            }
+        }
+
+        if (options.inputFile.empty())
+        {
+            throw BenchmarkOptionsException("Usage: benchmark FILE [arguments]");
+        }
+
+        return options;
+    }
+
+
+    double millisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+
+    // Returns the largest resident set size the process has had so far,
+    // in kilobytes.
+    long peakResidentKilobytes()
+    {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+
+    // Returns the given percentile of the sorted samples, by nearest rank.
+    double percentile(const std::vector<double>& sorted, double fraction)
+    {
+        if (sorted.empty())
+        {
+            return 0.0;
+        }
+
+        std::size_t rank = static_cast<std::size_t>(fraction * sorted.size());
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+
+
+    void reportStage(const std::string& stage, double milliseconds)
+    {
+        std::cout << std::left << std::setw(30) << stage << std::right
+                  << std::setw(12) << milliseconds << " ms"
+                  << std::setw(14) << peakResidentKilobytes() << " KB peak RSS\n";
+    }
+
+
+    void benchmarkText(const BenchmarkOptions& options)
+    {
+        std::ifstream file{options.inputFile};
+
+        if (!file)
+        {
+            throw MappedFileException("Could not open " + options.inputFile);
+        }
+
+        InputReader in{file};
+        std::pmr::monotonic_buffer_resource arena;
+        RoadMapReader reader;
+
+        Clock::time_point start = Clock::now();
+        RoadMap roadMap = reader.readRoadMap(in, &arena);
+        reportStage("text parse", millisecondsSince(start));
+
+        start = Clock::now();
+        CompactRoadGraph graph = freeze(roadMap);
+        reportStage("text freeze", millisecondsSince(start));
+    }
+
+
+    void benchmarkEngine(
+        const BenchmarkOptions& options, const std::string& engine,
+        const CompactRoadGraph& graph, const std::vector<Trip>& trips, WorkStealingPool& pool)
+    {
+        Clock::time_point start = Clock::now();
+        TripPlanner planner{graph, parseEngine(engine), pool};
+        reportStage(engine + " preprocess", millisecondsSince(start));
+
+        std::size_t queryCount = options.queries < 0
+            ? trips.size()
+            : std::min(trips.size(), static_cast<std::size_t>(options.queries));
+
+        std::vector<double> latencies;
+        latencies.reserve(queryCount);
+
+        start = Clock::now();
+
+        for (std::size_t trip = 0; trip < queryCount; ++trip)
+        {
+            Clock::time_point queryStart = Clock::now();
+            planner.planTrip(trips[trip]);
+            latencies.push_back(millisecondsSince(queryStart));
+        }
+
+        reportStage(engine + " single trips", millisecondsSince(start));
+
+        std::sort(latencies.begin(), latencies.end());
+
+        std::cout << std::left << std::setw(30) << (engine + " latency") << std::right
+                  << "p50 " << percentile(latencies, 0.50)
+                  << "  p90 " << percentile(latencies, 0.90)
+                  << "  p99 " << percentile(latencies, 0.99)
+                  << "  max " << (latencies.empty() ? 0.0 : latencies.back())
+                  << " ms over " << latencies.size() << " trips\n";
+
+        start = Clock::now();
+        planner.planTrips(trips, pool);
+        reportStage(engine + " batch", millisecondsSince(start));
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+
+    try
+    {
+        options = readBenchmarkOptions(argc, argv);
+    }
+    catch (BenchmarkOptionsException& e)
+    {
+        std::cerr << e.reason() << "\n";
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    try
+    {
+        if (!options.skipText)
+        {
+            benchmarkText(options);
+        }
+
+        Clock::time_point start = Clock::now();
+        MappedFile file{options.inputFile};
+        FastInputScanner scanner{file.data(), file.data() + file.size()};
+        FastRoadMapLoader loader;
+        CompactRoadGraph graph = loader.readRoadMap(scanner);
+        std::vector<Trip> trips = loader.readTrips(scanner);
+        reportStage("mmap load", millisecondsSince(start));
+
+        std::cout << graph.vertexCount() << " locations, " << graph.edgeCount()
+                  << " road segments, " << trips.size() << " trips, "
+                  << options.threads << " threads\n";
+
+        WorkStealingPool pool{options.threads};
+
+        for (const std::string& engine : options.engines)
+        {
+            benchmarkEngine(options, engine, graph, trips, pool);
+        }
+    }
+    catch (MappedFileException& e)
+    {
+        std::cerr << e.reason() << "\n";
+        return 1;
+    }
+    catch (InputFormatException& e)
+    {
+        std::cerr << e.reason() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
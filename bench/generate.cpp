@@ -0,0 +1,168 @@
+// generate.cpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// This is the main() function of the road network generator, a separate
+// program that writes a synthetic map and trips (see
+// RoadNetworkGenerator.hpp) to the standard output, in the format the
+// program reads.  Build it from the top of the repository with:
+//
+//     g++ -std=c++17 -O2 -Ibench bench/generate.cpp bench/RoadNetworkGenerator.cpp -o generate
+//
+// Recognized arguments:
+//
+//     --vertices=N       (the most locations the map may have; default 1000)
+//     --trips=N          (the number of trips; default 1000)
+//     --distance=F       (the fraction of trips, from 0 to 1, that ask for
+//                         the shortest distance rather than driving time;
+//                         default 0.5)
+//     --freeway-spacing=N
+//                        (streets between freeway corridors; default 10)
+//     --ramp-spacing=N   (avenues between freeway ramps; default 3)
+//     --seed=N           (default 1)
+//     --part=all|map|trips
+//                        (write the whole input, only the map, or only the
+//                         trips, as read alongside a --snapshot; default all)
+//
+// The same arguments always produce the same output.
+
+#include <iostream>
+#include <string>
+#include "RoadNetworkGenerator.hpp"
+
+
+namespace
+{
+    class GeneratorOptionsException
+    {
+    public:
+        GeneratorOptionsException(const std::string& reason): reason_{reason} { }
+
+        std::string reason() const { return reason_; }
+
+    private:
+        std::string reason_;
+    };
+
+
+    long long parseNumber(const std::string& name, const std::string& value, long long least)
+    {
+        std::size_t used = 0;
+        long long number = 0;
+
+        try
+        {
+            number = std::stoll(value, &used);
+        }
+        catch (std::exception&)
+        {
+            used = 0;
+        }
+
+        if (used == 0 || used != value.size() || number < least)
+        {
+            throw GeneratorOptionsException(
+                "Expected a number of at least " + std::to_string(least) + " for " + name);
+        }
+
+        return number;
+    }
+
+
+    double parseFraction(const std::string& name, const std::string& value)
+    {
+        std::size_t used = 0;
+        double fraction = -1.0;
+
+        try
+        {
+            fraction = std::stod(value, &used);
+        }
+        catch (std::exception&)
+        {
+            used = 0;
+        }
+
+        if (used == 0 || used != value.size() || !(fraction >= 0.0 && fraction <= 1.0))
+        {
+            throw GeneratorOptionsException("Expected a fraction from 0 to 1 for " + name);
+        }
+
+        return fraction;
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    RoadNetworkShape shape;
+    std::string part = "all";
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument = argv[i];
+            std::string::size_type equals = argument.find('=');
+            std::string name = argument.substr(0, equals);
+            std::string value = equals == std::string::npos ? "" : argument.substr(equals + 1);
+
+            if (name == "--vertices")
+            {
+                shape.vertexTarget = parseNumber(name, value, 1);
+            }
+            else if (name == "--trips")
+            {
+                shape.tripCount = static_cast<int>(parseNumber(name, value, 0));
+            }
+            else if (name == "--distance")
+            {
+                shape.distanceFraction = parseFraction(name, value);
+            }
+            else if (name == "--freeway-spacing")
+            {
+                shape.freewaySpacing = static_cast<int>(parseNumber(name, value, 1));
+            }
+            else if (name == "--ramp-spacing")
+            {
+                shape.rampSpacing = static_cast<int>(parseNumber(name, value, 1));
+            }
+            else if (name == "--seed")
+            {
+                shape.seed = static_cast<std::uint64_t>(parseNumber(name, value, 0));
+            }
+            else if (name == "--part" && (value == "all" || value == "map" || value == "trips"))
+            {
+                part = value;
+            }
+            else
+            {
+                throw GeneratorOptionsException("Unknown argument: " + argument);
+            }
+        }
+    }
+    catch (GeneratorOptionsException& e)
+    {
+        std::cerr << e.reason() << "\n";
+        return 1;
+    }
+
+    RoadNetworkGenerator generator{shape};
+
+    if (part != "trips")
+    {
+        generator.writeRoadMap(std::cout);
+    }
+
+    if (part != "map")
+    {
+        generator.writeTrips(std::cout);
+    }
+
+    std::cerr << generator.vertexCount() << " locations, "
+              << generator.edgeCount() << " road segments, "
+              << shape.tripCount << " trips\n";
+
+    return std::cout ? 0 : 1;
+}
@@ -15,20 +15,27 @@
 // In general, directed graphs are all the same, except in the sense
 // that they store different kinds of information about each vertex and
 // about each edge; these two types are the type parameters to the
-// Digraph class template.
+// Digraph class template.  A third, optional type parameter chooses how
+// the vertices are stored (see DigraphStorage.hpp).
 
 #ifndef DIGRAPH_HPP
 #define DIGRAPH_HPP
 
 #include <functional>
+#include <iterator>
 #include <list>
 #include <map>
+#include <memory_resource>
 #include <utility>
 #include <vector>
 #include <limits>
 #include <queue> 
+#include <unordered_map>
 #include <algorithm>
- 
+#include <string>
+#include "DigraphEdgeIndex.hpp"
+#include "DigraphStorage.hpp"
+#include "StrongComponents.hpp"
 
 
 
@@ -64,15 +71,85 @@ struct DigraphEdge
 
 
 
-// A DigraphVertex includes two things: a VertexInfo object and a list of
-// its outgoing edges.  Because different kinds of Digraphs store different
-// kinds of vertex and edge information, DigraphVertex is a template struct.
+// A DigraphPaths is the result of a single-source shortest path search.
+// It maps each vertex number to the predecessor chosen for that vertex
+// (with the same conventions as findShortestPaths()) and to the length of
+// the shortest path from the start vertex.  Vertices that were never reached
+// have a distance of std::numeric_limits<double>::infinity().
+
+struct DigraphPaths
+{
+    std::map<int, int> predecessors;
+    std::map<int, double> distances;
+};
+
+
+
+// A DigraphComponents is the result of a strongly connected components
+// analysis.  It maps each vertex number to the number of its component;
+// components are numbered 0..componentCount-1 in reverse topological
+// order, so every edge between two components leads to a lower-numbered
+// one.  condensation[c] lists, in increasing order, the other components
+// that some edge leaving component c leads to.
+
+struct DigraphComponents
+{
+    std::map<int, int> components;
+    int componentCount;
+    std::vector<std::vector<int>> condensation;
+};
+
+
+
+// A DigraphVertex includes three things: a VertexInfo object, a list of
+// its outgoing edges, and a list of its incoming edges, each of which
+// refers to the edge in the outgoing list of the vertex it comes from.
+// Because different kinds of Digraphs store different kinds of vertex and
+// edge information, DigraphVertex is a template struct.
+//
+// The edge lists allocate their nodes from a std::pmr::memory_resource.  The
+// constructors that take an allocator_type let the containers holding the
+// vertices pass their own allocator down, so every edge of a Digraph comes
+// from the same resource as its vertices.
 
 template <typename VertexInfo, typename EdgeInfo>
 struct DigraphVertex
 {
+    typedef std::pmr::polymorphic_allocator<DigraphEdge<EdgeInfo>> allocator_type;
+    typedef std::pmr::list<DigraphEdge<EdgeInfo>> EdgeList;
+    typedef std::pmr::list<typename EdgeList::iterator> IncomingList;
+
+    DigraphVertex() = default;
+    DigraphVertex(const DigraphVertex& other) = default;
+    DigraphVertex(DigraphVertex&& other) = default;
+
+    explicit DigraphVertex(const allocator_type& allocator)
+        : vinfo{}, edges{allocator}, incoming{allocator}
+    {
+    }
+
+    DigraphVertex(const VertexInfo& vinfo, const allocator_type& allocator)
+        : vinfo{vinfo}, edges{allocator}, incoming{allocator}
+    {
+    }
+
+    DigraphVertex(const DigraphVertex& other, const allocator_type& allocator)
+        : vinfo{other.vinfo}, edges{other.edges, allocator}, incoming{other.incoming, allocator}
+    {
+    }
+
+    DigraphVertex(DigraphVertex&& other, const allocator_type& allocator)
+        : vinfo{std::move(other.vinfo)}, edges{std::move(other.edges), allocator},
+          incoming{std::move(other.incoming), allocator}
+    {
+    }
+
+    DigraphVertex& operator=(const DigraphVertex& other) = default;
+    DigraphVertex& operator=(DigraphVertex&& other) = default;
+
     VertexInfo vinfo;
-    std::list<DigraphEdge<EdgeInfo>> edges;
+    EdgeList edges;
+    IncomingList incoming;
 };
 
 
@@ -83,6 +160,21 @@ struct DigraphVertex
 // * VertexInfo, which specifies the kind of object stored for each vertex
 // * EdgeInfo, which specifies the kind of object stored for each edge
 //
+// and optionally a third, VertexStorage, the storage policy that holds the
+// vertices: MapVertexStorage (the default) or DenseVertexStorage.
+//
+// All of a Digraph's vertices, edges and index slots are allocated from
+// one std::pmr::memory_resource, given to the constructor.  Handing it a
+// std::pmr::monotonic_buffer_resource lets a large graph be loaded without
+// a heap allocation per edge and released all at once; memory given back
+// by removeEdge() or removeVertex() is then only reclaimed with the arena.
+//
+// Every vertex keeps its incoming edges as well as its outgoing ones, and
+// a DigraphEdgeIndex maps each (from, to) pair to the edge's place in both
+// lists, so looking up, updating, adding or removing one edge takes
+// constant time however many edges meet at its vertices, and removing a
+// vertex only touches the edges it has.
+//
 // You'll need to implement the member functions declared here; each has a
 // comment detailing how it is intended to work.
 //
@@ -90,17 +182,24 @@ struct DigraphVertex
 // Vertex numbers are not necessarily sequential and they are not necessarily
 // zero- or one-based.
 
-template <typename VertexInfo, typename EdgeInfo>
+template <typename VertexInfo, typename EdgeInfo,
+          template <typename> class VertexStorage = MapVertexStorage>
 class Digraph
 {
 public:
     // The default constructor initializes a new, empty Digraph so that
-    // contains no vertices and no edges.
+    // contains no vertices and no edges, allocating from the default
+    // memory resource.
     Digraph();
 
+    // This constructor initializes a new, empty Digraph that allocates
+    // from the given memory resource, which must outlive it.
+    explicit Digraph(std::pmr::memory_resource* resource);
+
     // The copy constructor initializes a new Digraph to be a deep copy
     // of another one (i.e., any change to the copy will not affect the
-    // original).
+    // original).  As with std::pmr containers, the copy allocates from the
+    // default memory resource, not the original's.
     Digraph(const Digraph& d);
 
     // The move constructor initializes a new Digraph from an expiring one.
@@ -116,9 +215,13 @@ public:
     Digraph& operator=(const Digraph& d);
 
     // The move assignment operator assigns the contents of an expiring
-    // Digraph into "this" Digraph.
+    // Digraph into "this" Digraph.  Each Digraph keeps its own memory
+    // resource, so if the two differ, the contents are copied instead.
     Digraph& operator=(Digraph&& d);
 
+    // resource() returns the memory resource this Digraph allocates from.
+    std::pmr::memory_resource* resource() const;
+
     // vertices() returns a std::vector containing the vertex numbers of
     // every vertex in this Digraph.
     std::vector<int> vertices() const;
@@ -135,6 +238,31 @@ public:
     // not exist, a DigraphException is thrown instead.
     std::vector<std::pair<int, int>> edges(int vertex) const;
 
+    // forEachVertex() calls visit(vertex, vinfo) for every vertex in this
+    // Digraph, in increasing order of vertex number, passing the VertexInfo
+    // object by const reference.  Unlike vertices(), it allocates nothing.
+    template <typename Visitor>
+    void forEachVertex(Visitor visit) const;
+
+    // forEachEdge() calls visit(edge) for every edge in this Digraph, in
+    // the same order as edges(), passing each DigraphEdge by const
+    // reference.
+    template <typename Visitor>
+    void forEachEdge(Visitor visit) const;
+
+    // forEachOutEdge() calls visit(edge) for every edge outgoing from the
+    // given vertex number, in the order they were added.  If the given
+    // vertex does not exist, a DigraphException is thrown instead.
+    template <typename Visitor>
+    void forEachOutEdge(int vertex, Visitor visit) const;
+
+    // forEachInEdge() calls visit(edge) for every edge incoming to the
+    // given vertex number, which is how a search runs over the reverse
+    // graph.  If the given vertex does not exist, a DigraphException is
+    // thrown instead.
+    template <typename Visitor>
+    void forEachInEdge(int vertex, Visitor visit) const;
+
     // vertexInfo() returns the VertexInfo object belonging to the vertex
     // with the given vertex number.  If that vertex does not exist, a
     // DigraphException is thrown instead.
@@ -159,9 +287,16 @@ public:
     // present in the graph, a DigraphException is thrown instead.
     void addEdge(int fromVertex, int toVertex, const EdgeInfo& einfo);
 
+    // updateEdgeInfo() replaces the EdgeInfo object belonging to the edge
+    // with the given "from" and "to" vertex numbers, leaving the edge
+    // itself in place.  If either of those vertices does not exist *or*
+    // if the edge does not exist, a DigraphException is thrown instead.
+    void updateEdgeInfo(int fromVertex, int toVertex, const EdgeInfo& einfo);
+
     // removeVertex() removes the vertex (and all of its incoming
     // and outgoing edges) with the given vertex number from the
-    // Digraph.  If the vertex does not exist already, a DigraphException
+    // Digraph, in time proportional to the number of those edges.
+    // If the vertex does not exist already, a DigraphException
     // is thrown instead.
     void removeVertex(int vertex);
 
@@ -172,7 +307,8 @@ public:
     // thrown instead.
     void removeEdge(int fromVertex, int toVertex);
 
-    // vertexCount() returns the number of vertices in the graph.
+    // vertexCount() returns the number of vertices in the graph.  Like
+    // both overloads of edgeCount(), it takes constant time.
     int vertexCount() const;
 
     // edgeCount() returns the total number of edges in the graph,
@@ -185,11 +321,21 @@ public:
     // thrown instead.
     int edgeCount(int vertex) const;
 
+    // incomingEdgeCount() returns the number of edges in the graph that
+    // point to the given vertex number.  If the given vertex does not
+    // exist, a DigraphException is thrown instead.
+    int incomingEdgeCount(int vertex) const;
+
     // isStronglyConnected() returns true if the Digraph is strongly
     // connected (i.e., every vertex is reachable from every other),
     // false otherwise.
     bool isStronglyConnected() const;
 
+    // stronglyConnectedComponents() divides the vertices into strongly
+    // connected components, along with the condensation that connects
+    // them, in O(V + E) time and without recursion.
+    DigraphComponents stronglyConnectedComponents() const;
+
     // findShortestPaths() takes a start vertex number and a function
     // that takes an EdgeInfo object and determines an edge weight.
     // It uses Dijkstra's Shortest Path Algorithm to determine the
@@ -204,6 +350,25 @@ public:
         int startVertex,
         std::function<double(const EdgeInfo&)> edgeWeightFunc) const;
 
+    // findShortestPathTree() runs the same search as findShortestPaths(),
+    // but returns the distance labels along with the predecessors.  If the
+    // start vertex does not exist, a DigraphException is thrown instead.
+    DigraphPaths findShortestPathTree(
+        int startVertex,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc) const;
+
+    // These overloads of findShortestPaths() and findShortestPathTree()
+    // take the edge weight function as a template parameter instead of a
+    // std::function, so that a functor or lambda can be inlined into the
+    // relaxation loop.
+    template <typename EdgeWeightFunc>
+    std::map<int, int> findShortestPaths(
+        int startVertex, EdgeWeightFunc edgeWeightFunc) const;
+
+    template <typename EdgeWeightFunc>
+    DigraphPaths findShortestPathTree(
+        int startVertex, EdgeWeightFunc edgeWeightFunc) const;
+
 
 private:
     // Add whatever member variables you think you need here.  One
@@ -214,7 +379,29 @@ private:
   //  DigraphEdge* Edge; 
   //  int vertex_count; 
  //   int edges_count; 
-    std::map<int, DigraphVertex<VertexInfo,EdgeInfo>> GraphMap; 
+    typedef DigraphVertex<VertexInfo,EdgeInfo> Vertex;
+
+    // An edge's EdgePosition locates it in both of the lists it's in: the
+    // outgoing list of its "from" vertex and the incoming list of its
+    // "to" vertex.
+    struct EdgePosition
+    {
+        typename Vertex::EdgeList::iterator edge;
+        typename Vertex::IncomingList::iterator incoming;
+    };
+
+    VertexStorage<Vertex> GraphStorage;
+    DigraphEdgeIndex<EdgePosition> EdgeIndex;
+
+    // rebuildEdgeIndex() indexes every edge and rebuilds every incoming
+    // list from scratch; copies need it, because their edges live in new
+    // list nodes.
+    void rebuildEdgeIndex();
+
+    // findVertex() returns the vertex with the given vertex number, or
+    // throws a DigraphException with the given reason if there isn't one.
+    Vertex& findVertex(int vertex, const char* reason);
+    const Vertex& findVertex(int vertex, const char* reason) const;
 
     // You can also feel free to add any additional member functions
     // you'd like (public or private), so long as you don't remove or
@@ -226,37 +413,45 @@ private:
 // You'll need to define the member functions of your Digraph class
 // template here.
 
-template <typename VertexInfo, typename EdgeInfo>   
-Digraph<VertexInfo,EdgeInfo>::Digraph()    
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+Digraph<VertexInfo,EdgeInfo,VertexStorage>::Digraph()    
+    : Digraph{std::pmr::get_default_resource()}
 {    
 }
 
 
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+Digraph<VertexInfo,EdgeInfo,VertexStorage>::Digraph(std::pmr::memory_resource* resource)
+    : GraphStorage{resource}, EdgeIndex{resource}
+{
+}
+
+
 // The copy constructor initializes a new Digraph to be a deep copy            // should i keep those comments? 
 // of another one (i.e., any change to the copy will not affect the
 // original).
-template <typename VertexInfo, typename EdgeInfo>
-Digraph<VertexInfo,EdgeInfo>::Digraph(const Digraph& d)
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+Digraph<VertexInfo,EdgeInfo,VertexStorage>::Digraph(const Digraph& d)
+    : GraphStorage{d.GraphStorage}, EdgeIndex{GraphStorage.resource()}
 {
-   GraphMap.clear();                                                           //do i need to clear it ? 
-   GraphMap.insert(d.GraphMap.begin(),d.GraphMap.end());
+    rebuildEdgeIndex();
 }
 
 
 //the move constructor initializes a new Digraph from an expiring one. 
-template <typename VertexInfo, typename EdgeInfo>
-Digraph<VertexInfo,EdgeInfo>::Digraph(Digraph&& d)
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+Digraph<VertexInfo,EdgeInfo,VertexStorage>::Digraph(Digraph&& d)
+    : Digraph{d.resource()}
 {
-    GraphMap.clear();
-    std::swap(GraphMap,d.GraphMap);
+    std::swap(GraphStorage,d.GraphStorage);
+    std::swap(EdgeIndex,d.EdgeIndex);
 }
 
 
 //The destructor deallocates any memory associated with the Digraph.
-template <typename VertexInfo, typename EdgeInfo>
-Digraph<VertexInfo,EdgeInfo>::~Digraph()                                            // do i need it? 
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+Digraph<VertexInfo,EdgeInfo,VertexStorage>::~Digraph()                                            // do i need it? 
 {
-    GraphMap.clear(); 
 }
 
 
@@ -264,36 +459,48 @@ Digraph<VertexInfo,EdgeInfo>::~Digraph()
 // into "this" Digraph, with "this" Digraph becoming a separate, deep
 // copy of the contents of the given one (i.e., any change made to
 // "this" Digraph afterward will not affect the other).
-template <typename VertexInfo, typename EdgeInfo>
-Digraph<VertexInfo,EdgeInfo>& Digraph<VertexInfo,EdgeInfo>:: operator=(const Digraph& d)
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+Digraph<VertexInfo,EdgeInfo,VertexStorage>& Digraph<VertexInfo,EdgeInfo,VertexStorage>:: operator=(const Digraph& d)
 {
-    GraphMap.clear();
-    GraphMap.insert(d.GraphMap.begin(),d.GraphMap.end());
+    GraphStorage=d.GraphStorage;
+    rebuildEdgeIndex();
     return *this; 
 }
 
 
 //The move assignment operator assigns the contents of an expiring Digraph 
 //into "this" Digraph.
-template <typename VertexInfo, typename EdgeInfo>
-Digraph<VertexInfo,EdgeInfo>& Digraph<VertexInfo,EdgeInfo>:: operator=(Digraph&& d)
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+Digraph<VertexInfo,EdgeInfo,VertexStorage>& Digraph<VertexInfo,EdgeInfo,VertexStorage>:: operator=(Digraph&& d)
 {   
-    GraphMap.clear();
-    std::swap(GraphMap,d.GraphMap);
+    if(resource()!=d.resource())
+    {
+        return operator=(static_cast<const Digraph&>(d));
+    }
+    std::swap(GraphStorage,d.GraphStorage);
+    std::swap(EdgeIndex,d.EdgeIndex);
     return *this; 
 }
 
 
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+std::pmr::memory_resource* Digraph<VertexInfo,EdgeInfo,VertexStorage>:: resource() const
+{
+    return GraphStorage.resource();
+}
+
+
 //vertices () returns a std::vector containing the vertex numbers of 
 // every vertex in this digraph. 
-template <typename VertexInfo, typename EdgeInfo>
-std::vector<int> Digraph<VertexInfo,EdgeInfo>::vertices() const                    
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+std::vector<int> Digraph<VertexInfo,EdgeInfo,VertexStorage>::vertices() const                    
 {                                   
     std::vector<int> vertex_list;
-    for (auto element:GraphMap)
+    vertex_list.reserve(GraphStorage.size());
+    GraphStorage.forEach([&](int vertex, const Vertex&)
     {
-        vertex_list.push_back(element.first);
-    }
+        vertex_list.push_back(vertex);
+    });
     return vertex_list;
 }
 
@@ -301,17 +508,15 @@ std::vector<int> Digraph<VertexInfo,EdgeInfo>::vertices() const
 //edges() returns a std:: vector of std:: pair, in which each pair 
 //contains the "from" and "to" vertex number of an edge in this Digraph. 
 // All edges are included in the std:: vector.
-template <typename VertexInfo, typename EdgeInfo>
-std::vector<std::pair<int,int>> Digraph<VertexInfo,EdgeInfo>:: edges() const
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+std::vector<std::pair<int,int>> Digraph<VertexInfo,EdgeInfo,VertexStorage>:: edges() const
 {
     std::vector<std::pair<int,int>> edges_list; 
-    for(auto element:GraphMap)
+    edges_list.reserve(edgeCount());
+    forEachEdge([&](const DigraphEdge<EdgeInfo>& edge_element)
     {
-        for(auto edge_element:element.second.edges) 
-        {
-            edges_list.push_back(std::pair<int,int>(edge_element.fromVertex,edge_element.toVertex));
-        }
-    }
+        edges_list.push_back(std::pair<int,int>(edge_element.fromVertex,edge_element.toVertex));
+    });
     return edges_list;
 }
 
@@ -320,40 +525,73 @@ std::vector<std::pair<int,int>> Digraph<VertexInfo,EdgeInfo>:: edges() const
 //"from" and "to" vertex numbers of an edge in this Digraph. Only edges outgoing fro the given vertex
 // number are included in the std:: vector. 
 // If the given vertex does not exist, a DigraphException is thrown instead. 
-template <typename VertexInfo, typename EdgeInfo>
-std::vector<std::pair<int,int>> Digraph<VertexInfo,EdgeInfo>:: edges(int vertex) const
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+std::vector<std::pair<int,int>> Digraph<VertexInfo,EdgeInfo,VertexStorage>:: edges(int vertex) const
 {
     std::vector<std::pair<int,int>> edges_list;
-    DigraphException Exception("Given vertex does not exist.");
-    if(GraphMap.find(vertex)==GraphMap.end())
+    edges_list.reserve(edgeCount(vertex));
+    forEachOutEdge(vertex,[&](const DigraphEdge<EdgeInfo>& element)
     {
-        throw Exception;
-    }
-    else
-    { 
-        for(auto element:GraphMap.at(vertex).edges)
+        edges_list.push_back(std::pair<int,int>(element.fromVertex,element.toVertex));
+    });
+    return edges_list;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+template <typename Visitor>
+void Digraph<VertexInfo,EdgeInfo,VertexStorage>:: forEachVertex(Visitor visit) const
+{
+    GraphStorage.forEach([&](int vertex, const Vertex& element)
+    {
+        visit(vertex,element.vinfo);
+    });
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+template <typename Visitor>
+void Digraph<VertexInfo,EdgeInfo,VertexStorage>:: forEachEdge(Visitor visit) const
+{
+    GraphStorage.forEach([&](int, const Vertex& element)
+    {
+        for(const auto& edge:element.edges)
         {
-            edges_list.push_back(std::pair<int,int>(element.fromVertex,element.toVertex));
+            visit(edge);
         }
-    } 
-    return edges_list;
+    });
 }
 
 
-// vertexInfo() returns the VertexInfo object belonging to the vertex
-// with the given vertex number.  If that vertex does not exist, a
-// DigraphException is thrown instead.
-template <typename VertexInfo, typename EdgeInfo>
-VertexInfo Digraph<VertexInfo,EdgeInfo>:: vertexInfo(int vertex) const
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+template <typename Visitor>
+void Digraph<VertexInfo,EdgeInfo,VertexStorage>:: forEachOutEdge(int vertex, Visitor visit) const
 {
-    DigraphException Exception("Vertex does not exist.");
-    if(GraphMap.find(vertex)!=GraphMap.end())
+    for(const auto& edge:findVertex(vertex,"Given vertex does not exist.").edges)
     {
-        return GraphMap.at(vertex).vinfo;
+        visit(edge);
     }
+}
 
-    else
-        throw Exception;
+
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+template <typename Visitor>
+void Digraph<VertexInfo,EdgeInfo,VertexStorage>:: forEachInEdge(int vertex, Visitor visit) const
+{
+    for(const auto& edge:findVertex(vertex,"Given vertex does not exist.").incoming)
+    {
+        visit(static_cast<const DigraphEdge<EdgeInfo>&>(*edge));
+    }
+}
+
+
+// vertexInfo() returns the VertexInfo object belonging to the vertex
+// with the given vertex number.  If that vertex does not exist, a
+// DigraphException is thrown instead.
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+VertexInfo Digraph<VertexInfo,EdgeInfo,VertexStorage>:: vertexInfo(int vertex) const
+{
+    return findVertex(vertex,"Vertex does not exist.").vinfo;
 }
 
 
@@ -361,18 +599,17 @@ VertexInfo Digraph<VertexInfo,EdgeInfo>:: vertexInfo(int vertex) const
 // with the given "from" and "to" vertex numbers.  If either of those
 // vertices does not exist *or* if the edge does not exist, a
 // DigraphException is thrown instead.
-template <typename VertexInfo, typename EdgeInfo>
-EdgeInfo Digraph<VertexInfo,EdgeInfo>:: edgeInfo(int fromVertex, int toVertex) const
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+EdgeInfo Digraph<VertexInfo,EdgeInfo,VertexStorage>:: edgeInfo(int fromVertex, int toVertex) const
 {
-    DigraphException Exception("Edge does not exist or one of those vertices does not exist");
-    for(auto element: GraphMap.at(fromVertex).edges)
+    const char* reason="Edge does not exist or one of those vertices does not exist";
+    findVertex(fromVertex,reason);
+    const EdgePosition* position=EdgeIndex.find(fromVertex,toVertex);
+    if(position==nullptr)
     {
-        if(toVertex==element.toVertex)
-        {
-            return element.einfo; 
-        }
+        throw DigraphException(reason);
     }
-    throw Exception;
+    return position->edge->einfo;
 }
 
 
@@ -380,20 +617,21 @@ EdgeInfo Digraph<VertexInfo,EdgeInfo>:: edgeInfo(int fromVertex, int toVertex) c
 // number and VertexInfo object.  If there is already a vertex in
 // the graph with the given vertex number, a DigraphException is
 // thrown instead.
-template <typename VertexInfo, typename EdgeInfo>
-void Digraph<VertexInfo,EdgeInfo>:: addVertex(int vertex, const VertexInfo& vinfo)
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+void Digraph<VertexInfo,EdgeInfo,VertexStorage>:: addVertex(int vertex, const VertexInfo& vinfo)
 {
     DigraphException Exception("There is already a vertex in the graph with the given vertex number");
-    if(GraphMap.find(vertex)!=GraphMap.end())
+    if(GraphStorage.find(vertex)!=nullptr)
     {
         throw Exception; 
     }
+    else if(!GraphStorage.accepts(vertex))
+    {
+        throw DigraphException("The vertex number can't be stored in this graph");
+    }
     else
     {
-        DigraphVertex<VertexInfo,EdgeInfo>* Graph_Vertex= new DigraphVertex<VertexInfo,EdgeInfo>();
-        Graph_Vertex->vinfo=vinfo;  
-        GraphMap[vertex]=*Graph_Vertex;   
-        delete Graph_Vertex;  
+        GraphStorage.emplace(vertex,vinfo);
     } 
 }
 
@@ -402,67 +640,86 @@ void Digraph<VertexInfo,EdgeInfo>:: addVertex(int vertex, const VertexInfo& vinf
 //to the given "to" vertex number, and associates with the given EdgeInfo objects with it
 // if one of the vertices does not exist *or* if the same edge is already present in the graph,
 // a DigraphException is thrown instead. 
-template <typename VertexInfo, typename EdgeInfo>  //EdgeInfo is a roadsegment 
-void Digraph<VertexInfo,EdgeInfo>:: addEdge(int fromVertex,int toVertex,const EdgeInfo& einfo)          //check this function 
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage> //EdgeInfo is a roadsegment 
+void Digraph<VertexInfo,EdgeInfo,VertexStorage>:: addEdge(int fromVertex,int toVertex,const EdgeInfo& einfo)          //check this function 
 {
     //problem: do we need to check if, if not exist what we should do ? 
     //exception 
-    DigraphException Exception1("One of the vertices does not exist");
     DigraphException Exception2("the same edge is already present in the graph");
-    std::vector<std::pair<int,int>> edges_fromVertex=edges(fromVertex);
-    if((GraphMap.find(fromVertex)==GraphMap.end())||(GraphMap.find(toVertex)==GraphMap.end()))
-    {
-        throw Exception1;
-    }
-    bool edgefound=find(edges_fromVertex.begin(),edges_fromVertex.end(),std::pair<int,int>(fromVertex,toVertex))!=edges_fromVertex.end();
+    Vertex& from=findVertex(fromVertex,"One of the vertices does not exist");
+    Vertex& to=findVertex(toVertex,"One of the vertices does not exist");
+    bool edgefound=EdgeIndex.find(fromVertex,toVertex)!=nullptr;
     if(edgefound)
     {
         throw Exception2;
     }
     else
     { 
-        DigraphEdge<EdgeInfo>* Graph_Edge= new DigraphEdge<EdgeInfo>();  
-        Graph_Edge->fromVertex=fromVertex;
-        Graph_Edge->toVertex=toVertex;
-        Graph_Edge->einfo=einfo;
-        GraphMap.at(fromVertex).edges.push_back(*Graph_Edge);
-        delete Graph_Edge;
+        from.edges.push_back(DigraphEdge<EdgeInfo>{fromVertex,toVertex,einfo});
+        to.incoming.push_back(std::prev(from.edges.end()));
+        EdgeIndex.insert(fromVertex,toVertex,
+            EdgePosition{std::prev(from.edges.end()),std::prev(to.incoming.end())});
     }
 }
 
 
+// updateEdgeInfo() replaces the EdgeInfo object belonging to the edge
+// with the given "from" and "to" vertex numbers, leaving the edge in place.
+// If either of those vertices does not exist *or* if the edge does not
+// exist, a DigraphException is thrown instead.
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+void Digraph<VertexInfo,EdgeInfo,VertexStorage>:: updateEdgeInfo(int fromVertex, int toVertex, const EdgeInfo& einfo)
+{
+    const char* reason="Edge does not exist or one of those vertices does not exist";
+    DigraphException Exception(reason);
+    findVertex(fromVertex,reason);
+    findVertex(toVertex,reason);
+    const EdgePosition* position=EdgeIndex.find(fromVertex,toVertex);
+    if(position==nullptr)
+    {
+        throw Exception;
+    }
+    position->edge->einfo=einfo;
+}
+
+
 //removeVertex() removes the vertex ( and all of its incoming and outoing edges)
 // with the given vertex number from the Dgiraph. 
 // If the vertex does not exist alrady, a DigraphException is thrown instead. 
-template <typename VertexInfo, typename EdgeInfo>
-void Digraph<VertexInfo,EdgeInfo>:: removeVertex(int vertex)
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+void Digraph<VertexInfo,EdgeInfo,VertexStorage>:: removeVertex(int vertex)
 {
     //exception
     DigraphException Exception("The vertex does not exist already.");
-    if(GraphMap.find(vertex)==GraphMap.end())
+    if(GraphStorage.find(vertex)==nullptr)
     {
         throw Exception;
     }
     else
     {
-        std::vector<DigraphEdge<EdgeInfo>> remove_list; 
-        if(GraphMap.find(vertex)!=GraphMap.end())
+        // Only the edges touching the vertex are visited: each outgoing
+        // edge is unlinked from the incoming list of the vertex it points
+        // to, and each incoming edge from the outgoing list it lives in.
+        Vertex& removed=*GraphStorage.find(vertex);
+        for(const auto& element:removed.edges)
         {
-            GraphMap.erase(vertex);
+            if(element.toVertex!=vertex)
+            {
+                GraphStorage.find(element.toVertex)->incoming.erase(
+                    EdgeIndex.find(vertex,element.toVertex)->incoming);
+            }
+            EdgeIndex.erase(vertex,element.toVertex);
         }
-
-        for(auto element:GraphMap)
+        for(auto edge:removed.incoming)
         {
-            for(auto sub_element:element.second.edges)
+            int from_vertex=edge->fromVertex;
+            if(from_vertex!=vertex)
             {
-                sub_element=element.second.edges.back();
-                element.second.edges.pop_back();
-                if(sub_element.toVertex!=vertex)
-                {
-                    element.second.edges.push_front(sub_element);
-                }
+                GraphStorage.find(from_vertex)->edges.erase(edge);
+                EdgeIndex.erase(from_vertex,vertex);
             }
         }
+        GraphStorage.erase(vertex);
     }
 }
 
@@ -471,97 +728,119 @@ void Digraph<VertexInfo,EdgeInfo>:: removeVertex(int vertex)
 // given "to" the given "to" vertex number from the Digraph. 
 // if either of these vertices does not exist *or* if the edge is not already present in the graph,
 // a DigraphException is thrown insead. 
-template <typename VertexInfo, typename EdgeInfo>
-void Digraph<VertexInfo,EdgeInfo>:: removeEdge(int fromVertex,int toVertex)
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+void Digraph<VertexInfo,EdgeInfo,VertexStorage>:: removeEdge(int fromVertex,int toVertex)
 {
-    DigraphException Exception1("One of the vertices does not exist");
     DigraphException Exception2("the edge is not already present in the graph");
-    std::vector<std::pair<int,int>> edges_fromVertex=edges(fromVertex);
-    if((GraphMap.find(fromVertex)==GraphMap.end())||(GraphMap.find(toVertex)==GraphMap.end()))
-    {
-        throw Exception1;
-    }
-    bool edgefound=find(edges_fromVertex.begin(),edges_fromVertex.end(),std::pair<int,int>(fromVertex,toVertex))!=edges_fromVertex.end();
-    if(!edgefound)
+    Vertex& from=findVertex(fromVertex,"One of the vertices does not exist");
+    Vertex& to=findVertex(toVertex,"One of the vertices does not exist");
+    const EdgePosition* position=EdgeIndex.find(fromVertex,toVertex);
+    if(position==nullptr)
     {
         throw Exception2;
     }
     else
     {
-        for(auto element:GraphMap.at(fromVertex).edges)
-        {   
-            element=GraphMap.at(fromVertex).edges.back(); 
-            GraphMap.at(fromVertex).edges.pop_back(); 
-            if(element.toVertex!=toVertex)
-            {
-                GraphMap.at(fromVertex).edges.push_back(element);
-            }
-        }
+        to.incoming.erase(position->incoming);
+        from.edges.erase(position->edge);
+        EdgeIndex.erase(fromVertex,toVertex);
     }
 }
 
 
-template <typename VertexInfo, typename EdgeInfo>
-int Digraph<VertexInfo,EdgeInfo>:: vertexCount() const
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+int Digraph<VertexInfo,EdgeInfo,VertexStorage>:: vertexCount() const
 {
-    return GraphMap.size();
+    return GraphStorage.size();
 }
 
 
-template <typename VertexInfo, typename EdgeInfo>
-int Digraph<VertexInfo,EdgeInfo>:: edgeCount() const
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+int Digraph<VertexInfo,EdgeInfo,VertexStorage>:: edgeCount() const
 {
-    std::vector<std::pair<int,int>> edgeslist=edges();
-    return edgeslist.size(); 
+    // Every edge is in the index exactly once.
+    return static_cast<int>(EdgeIndex.size());
 }
 
 
 // This overload of edgeCount() returns the number of edges in the graph that
 // are outgoing from the given vertex number. 
 //If the given vertex does not exist, a Digraph Exception is thrown isntead
-template <typename VertexInfo, typename EdgeInfo>
-int Digraph<VertexInfo,EdgeInfo>:: edgeCount(int vertex) const
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+int Digraph<VertexInfo,EdgeInfo,VertexStorage>:: edgeCount(int vertex) const
 {
-    DigraphException Exception("the given vertex does not exist.");
-    if(GraphMap.find(vertex)!=GraphMap.end())
-    {
-        std::vector<std::pair<int,int>> edgeslist=edges(vertex);
-        return edgeslist.size(); 
-    }
-    else
-        throw Exception;
+    return findVertex(vertex,"the given vertex does not exist.").edges.size();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+int Digraph<VertexInfo,EdgeInfo,VertexStorage>:: incomingEdgeCount(int vertex) const
+{
+    return findVertex(vertex,"the given vertex does not exist.").incoming.size();
 }
 
 
 // isstronglyConnected() return true if the Digraph is strongly connected
 //(i.e., every vertex is reachable from every other), false otherwise. 
-template <typename VertexInfo, typename EdgeInfo>
-bool Digraph<VertexInfo,EdgeInfo>:: isStronglyConnected() const
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+bool Digraph<VertexInfo,EdgeInfo,VertexStorage>:: isStronglyConnected() const
+{
+    return stronglyConnectedComponents().componentCount<=1;
+}
+
+
+// stronglyConnectedComponents() renumbers the vertices 0..N-1 in increasing
+// order, lays the edges out the way findStrongComponents() expects, and
+// maps the component numbers back to vertex numbers.
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+DigraphComponents Digraph<VertexInfo,EdgeInfo,VertexStorage>:: stronglyConnectedComponents() const
 {
-    std::map<int,bool> visitedmap;
-    for(auto key:GraphMap) 
+    std::vector<int> vertex_list=vertices();
+    int vertex_count=static_cast<int>(vertex_list.size());
+
+    std::unordered_map<int,int> dense_numbers;
+    dense_numbers.reserve(vertex_count);
+    for(int i=0;i<vertex_count;++i)
     {
-        visitedmap[key.first]=false;
+        dense_numbers.emplace(vertex_list[i],i);
     }
 
-    for(auto key:GraphMap)
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    offsets.reserve(vertex_count+1);
+    targets.reserve(edgeCount());
+    offsets.push_back(0);
+    GraphStorage.forEach([&](int, const Vertex& element)
     {
-        std::map<int,bool> visitmap_copy=visitedmap; 
-        int vertex_count=0; 
-        for(auto element:key.second.edges)
+        for(const auto& edge:element.edges)
         {
-            if(visitmap_copy[element.toVertex]==false)
-            {
-                vertex_count++;
-                visitmap_copy[element.toVertex]=true; 
-            }
-        }
-        if(vertex_count!=vertexCount())
-        {
-            return false;
+            targets.push_back(dense_numbers.at(edge.toVertex));
         }
+        offsets.push_back(static_cast<int>(targets.size()));
+    });
+
+    std::vector<int> components(vertex_count);
+    DigraphComponents result;
+    result.componentCount=findStrongComponents(vertex_count,offsets.data(),targets.data(),components.data());
+
+    for(int i=0;i<vertex_count;++i)
+    {
+        result.components.emplace_hint(result.components.end(),vertex_list[i],components[i]);
     }
-    return true; 
+
+    std::vector<int> condensed_offsets;
+    std::vector<int> condensed_targets;
+    condenseComponents(vertex_count,offsets.data(),targets.data(),components.data(),
+        result.componentCount,condensed_offsets,condensed_targets);
+
+    result.condensation.resize(result.componentCount);
+    for(int component=0;component<result.componentCount;++component)
+    {
+        result.condensation[component].assign(
+            condensed_targets.begin()+condensed_offsets[component],
+            condensed_targets.begin()+condensed_offsets[component+1]);
+    }
+    return result;
 }
 
 
@@ -573,55 +852,128 @@ is returned as a std:: map<int, int> where the keys are vertex numbers and teh v
 precedessor of that vertex chosen by the algorithm. 
 For any vertex without a predecessor (e.g., a vertex that was never rached, or the start vertex itself) 
 the value is simply a copy of the key. */
-template <typename VertexInfo, typename EdgeInfo>
-std::map<int,int> Digraph<VertexInfo,EdgeInfo>:: findShortestPaths(
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+std::map<int,int> Digraph<VertexInfo,EdgeInfo,VertexStorage>:: findShortestPaths(
         int startVertex,
         std::function<double(const EdgeInfo&)> edgeWeightFunc) const
 { 
-    std::map<int,bool> kmap; 
-    std::map<int,double> dmap; 
-    std::map<int,int> pmap; 
-    for(auto key:GraphMap)
-    {
-            kmap[key.first]=false; 
-            dmap[key.first]=std::numeric_limits<double>::max(); 
-            pmap[key.first]=key.first;
-    }
-    dmap[startVertex]=0.0; 
+    return findShortestPathTree<std::function<double(const EdgeInfo&)>>(
+        startVertex, edgeWeightFunc).predecessors;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+template <typename EdgeWeightFunc>
+std::map<int,int> Digraph<VertexInfo,EdgeInfo,VertexStorage>:: findShortestPaths(
+        int startVertex, EdgeWeightFunc edgeWeightFunc) const
+{
+    return findShortestPathTree<EdgeWeightFunc>(startVertex, edgeWeightFunc).predecessors;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+DigraphPaths Digraph<VertexInfo,EdgeInfo,VertexStorage>:: findShortestPathTree(
+        int startVertex,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc) const
+{
+    return findShortestPathTree<std::function<double(const EdgeInfo&)>>(
+        startVertex, edgeWeightFunc);
+}
+
+
+// findShortestPathTree() is Dijkstra's algorithm driven by a lazy-deletion
+// heap of (distance, vertex) pairs.  A vertex is pushed again whenever its
+// distance improves, and entries whose distance no longer matches the
+// vertex's label are skipped when popped, so each pop identifies its vertex
+// directly and ties are broken by vertex number.
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+template <typename EdgeWeightFunc>
+DigraphPaths Digraph<VertexInfo,EdgeInfo,VertexStorage>:: findShortestPathTree(
+        int startVertex, EdgeWeightFunc edgeWeightFunc) const
+{
+    findVertex(startVertex,"Start vertex does not exist.");
+
+    DigraphPaths paths;
+    GraphStorage.forEach([&](int vertex, const Vertex&)
+    {
+        paths.predecessors.emplace_hint(paths.predecessors.end(),vertex,vertex);
+        paths.distances.emplace_hint(paths.distances.end(),vertex,std::numeric_limits<double>::infinity());
+    });
+    paths.distances[startVertex]=0.0;
 
-    std::priority_queue<double,std::vector<double>,std::greater<double>> distance_queue; 
-    distance_queue.push(dmap[startVertex]);
+    typedef std::pair<double,int> QueueEntry;
+    std::priority_queue<QueueEntry,std::vector<QueueEntry>,std::greater<QueueEntry>> distance_queue;
+    distance_queue.push(QueueEntry(0.0,startVertex));
 
     while(!distance_queue.empty())
     {
-        int smallkey;
-        for(auto element:dmap)
+        QueueEntry smallest=distance_queue.top();
+        distance_queue.pop();
+
+        if(smallest.first>paths.distances.at(smallest.second))
         {
-            if(element.second==distance_queue.top())
-            {
-                smallkey=element.first; 
-            }
+            continue;
         }
 
-        distance_queue.pop(); 
-
-        if(kmap[smallkey]==false)
+        for(const auto& edge:GraphStorage.find(smallest.second)->edges)
         {
-            kmap[smallkey]=true; 
-        
-            for(auto edge:GraphMap.at(smallkey).edges)
+            double candidate=smallest.first+edgeWeightFunc(edge.einfo);
+            double& current=paths.distances.at(edge.toVertex);
+            if(candidate<current)
             {
-                if(dmap.at(edge.toVertex)>dmap.at(smallkey)+edgeWeightFunc(edge.einfo))
-                {
-                    dmap[edge.toVertex]=dmap[smallkey]+edgeWeightFunc(edge.einfo);
-                    pmap[edge.toVertex]=smallkey;
-                    distance_queue.push(dmap.at(edge.toVertex));
-                }
+                current=candidate;
+                paths.predecessors.at(edge.toVertex)=smallest.second;
+                distance_queue.push(QueueEntry(candidate,edge.toVertex));
             }
+        }
+    }
+    return paths;
+}
+
+
 
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+void Digraph<VertexInfo,EdgeInfo,VertexStorage>:: rebuildEdgeIndex()
+{
+    EdgeIndex.clear();
+    GraphStorage.forEach([&](int, Vertex& element)
+    {
+        element.incoming.clear();
+    });
+    GraphStorage.forEach([&](int, Vertex& element)
+    {
+        for(auto edge=element.edges.begin();edge!=element.edges.end();++edge)
+        {
+            auto& incoming=GraphStorage.find(edge->toVertex)->incoming;
+            incoming.push_back(edge);
+            EdgeIndex.insert(edge->fromVertex,edge->toVertex,
+                EdgePosition{edge,std::prev(incoming.end())});
         }
+    });
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+typename Digraph<VertexInfo,EdgeInfo,VertexStorage>::Vertex& Digraph<VertexInfo,EdgeInfo,VertexStorage>:: findVertex(int vertex, const char* reason)
+{
+    Vertex* found=GraphStorage.find(vertex);
+    if(found==nullptr)
+    {
+        throw DigraphException(reason);
+    }
+    return *found;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo, template <typename> class VertexStorage>
+const typename Digraph<VertexInfo,EdgeInfo,VertexStorage>::Vertex& Digraph<VertexInfo,EdgeInfo,VertexStorage>:: findVertex(int vertex, const char* reason) const
+{
+    const Vertex* found=GraphStorage.find(vertex);
+    if(found==nullptr)
+    {
+        throw DigraphException(reason);
     }
-    return pmap; 
+    return *found;
 }
 
 #endif // DIGRAPH_HPP
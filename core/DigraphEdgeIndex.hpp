@@ -0,0 +1,182 @@
+// DigraphEdgeIndex.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// This header file declares DigraphEdgeIndex, the hash table a Digraph
+// uses to find an edge from its "from" and "to" vertex numbers without
+// scanning the "from" vertex's edge list.
+//
+// The table uses open addressing with linear probing: every key lives in
+// one flat array of slots, so a lookup touches one or two adjacent slots
+// and never allocates.  The table doubles once it's half full, and removal
+// shifts the entries that follow back into the gap instead of leaving
+// tombstones, so lookups stay short however many edges come and go.
+//
+// The value stored for each edge is a Position, which the Digraph chooses;
+// it must stay valid while the edge exists (a std::list iterator does).
+// The slots are allocated from a std::pmr::memory_resource, normally the
+// same one the Digraph allocates its vertices and edges from.
+
+#ifndef DIGRAPHEDGEINDEX_HPP
+#define DIGRAPHEDGEINDEX_HPP
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+
+
+template <typename Position>
+class DigraphEdgeIndex
+{
+public:
+    explicit DigraphEdgeIndex(std::pmr::memory_resource* resource)
+        : slots_(resource), size_{0}, shift_{64}
+    {
+    }
+
+    // find() returns a pointer to the position stored for the edge from
+    // one vertex to another, or nullptr if there is no such edge.
+    const Position* find(int fromVertex, int toVertex) const
+    {
+        if (slots_.empty())
+        {
+            return nullptr;
+        }
+
+        std::uint64_t key = makeKey(fromVertex, toVertex);
+
+        for (std::size_t slot = home(key); slots_[slot].used; slot = next(slot))
+        {
+            if (slots_[slot].key == key)
+            {
+                return &slots_[slot].position;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // insert() stores the position of an edge that isn't in the index.
+    void insert(int fromVertex, int toVertex, const Position& position)
+    {
+        if (2 * (size_ + 1) > slots_.size())
+        {
+            grow();
+        }
+
+        place(makeKey(fromVertex, toVertex), position);
+        ++size_;
+    }
+
+    // erase() removes the edge from one vertex to another, which must be
+    // in the index.
+    void erase(int fromVertex, int toVertex)
+    {
+        std::uint64_t key = makeKey(fromVertex, toVertex);
+        std::size_t gap = home(key);
+
+        while (slots_[gap].key != key)
+        {
+            gap = next(gap);
+        }
+
+        // Every entry in the run after the gap whose home slot doesn't lie
+        // between the gap and the entry moves back into the gap, which
+        // keeps every entry reachable from its home slot.
+        for (std::size_t slot = next(gap); slots_[slot].used; slot = next(slot))
+        {
+            std::size_t wanted = home(slots_[slot].key);
+
+            if (((slot - wanted) & mask()) >= ((slot - gap) & mask()))
+            {
+                slots_[gap] = slots_[slot];
+                gap = slot;
+            }
+        }
+
+        slots_[gap] = Slot{};
+        --size_;
+    }
+
+    // clear() removes every edge from the index.
+    void clear()
+    {
+        slots_.clear();
+        size_ = 0;
+    }
+
+    // size() returns the number of edges in the index.
+    std::size_t size() const { return size_; }
+
+private:
+    struct Slot
+    {
+        std::uint64_t key = 0;
+        Position position{};
+        bool used = false;
+    };
+
+    static std::uint64_t makeKey(int fromVertex, int toVertex)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(fromVertex)) << 32)
+            | static_cast<std::uint32_t>(toVertex);
+    }
+
+    // The key is scrambled with a 64-bit multiplicative hash, whose high
+    // bits are the best mixed, so those pick the home slot.
+    std::size_t home(std::uint64_t key) const
+    {
+        return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_) & mask();
+    }
+
+    std::size_t next(std::size_t slot) const { return (slot + 1) & mask(); }
+    std::size_t mask() const { return slots_.size() - 1; }
+
+    void place(std::uint64_t key, const Position& position)
+    {
+        std::size_t slot = home(key);
+
+        while (slots_[slot].used)
+        {
+            slot = next(slot);
+        }
+
+        slots_[slot].key = key;
+        slots_[slot].position = position;
+        slots_[slot].used = true;
+    }
+
+    void grow()
+    {
+        std::pmr::vector<Slot> old{slots_.get_allocator()};
+        old.swap(slots_);
+
+        std::size_t capacity = old.empty() ? 16 : 2 * old.size();
+        slots_.resize(capacity);
+
+        shift_ = 64;
+        for (std::size_t bits = capacity; bits > 1; bits >>= 1)
+        {
+            --shift_;
+        }
+
+        for (const Slot& slot : old)
+        {
+            if (slot.used)
+            {
+                place(slot.key, slot.position);
+            }
+        }
+    }
+
+private:
+    std::pmr::vector<Slot> slots_;
+    std::size_t size_;
+    unsigned shift_;
+};
+
+
+
+#endif // DIGRAPHEDGEINDEX_HPP
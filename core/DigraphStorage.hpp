@@ -0,0 +1,214 @@
+// DigraphStorage.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// This header file declares the vertex storage policies that a Digraph
+// can be instantiated with.  A storage policy is a class template that
+// takes the Digraph's vertex type and keeps one vertex object per vertex
+// number; the Digraph does everything else.
+//
+// * MapVertexStorage keeps the vertices in a std::map, so vertex numbers
+//   can be anything at all, but every lookup walks a balanced tree.
+//
+// * DenseVertexStorage keeps the vertices in a std::deque indexed by
+//   vertex number, with a bitmap recording which slots hold a vertex, so
+//   every lookup is a single index.  It suits graphs whose vertices are
+//   numbered 0..N-1 (or close to it), since it allocates a slot for every
+//   number up to the largest one in use.  Removing a vertex leaves a
+//   tombstone in its slot, which a later addVertex() can fill again.
+//
+// Both policies allocate from the std::pmr::memory_resource they're given,
+// which they pass along to the vertices they construct, so a Digraph built
+// on an arena keeps its vertices and edges there.
+//
+// Both policies visit vertices in increasing order of vertex number, so a
+// Digraph behaves the same way whichever one it uses, and neither ever
+// moves a stored vertex, so the Digraph can keep iterators into a vertex's
+// edge list for as long as the vertex exists.  (That's why the dense policy
+// grows a std::deque rather than a std::vector.)
+
+#ifndef DIGRAPHSTORAGE_HPP
+#define DIGRAPHSTORAGE_HPP
+
+#include <deque>
+#include <map>
+#include <memory_resource>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+
+template <typename Vertex>
+class MapVertexStorage
+{
+public:
+    explicit MapVertexStorage(std::pmr::memory_resource* resource)
+        : vertices_(resource)
+    {
+    }
+
+    // resource() returns the memory resource the storage allocates from.
+    std::pmr::memory_resource* resource() const
+    {
+        return vertices_.get_allocator().resource();
+    }
+
+    // accepts() returns true if the given vertex number can be stored.
+    bool accepts(int) const { return true; }
+
+    // find() returns the vertex with the given vertex number, or nullptr
+    // if there isn't one.
+    Vertex* find(int vertex)
+    {
+        auto found = vertices_.find(vertex);
+        return found == vertices_.end() ? nullptr : &found->second;
+    }
+
+    const Vertex* find(int vertex) const
+    {
+        auto found = vertices_.find(vertex);
+        return found == vertices_.end() ? nullptr : &found->second;
+    }
+
+    // emplace() constructs a vertex in place under a vertex number that
+    // isn't in use, passing the given arguments and then the storage's
+    // allocator to the vertex's constructor.
+    template <typename... Args>
+    void emplace(int vertex, Args&&... args)
+    {
+        vertices_.emplace(
+            std::piecewise_construct, std::forward_as_tuple(vertex),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    // erase() removes the vertex with the given vertex number, which must
+    // be in use.
+    void erase(int vertex) { vertices_.erase(vertex); }
+
+    // size() returns the number of vertices stored.
+    int size() const { return static_cast<int>(vertices_.size()); }
+
+    // forEach() calls visit(vertexNumber, vertex) for every vertex, in
+    // increasing order of vertex number.
+    template <typename Visitor>
+    void forEach(Visitor visit) const
+    {
+        for (const auto& element : vertices_)
+        {
+            visit(element.first, element.second);
+        }
+    }
+
+    template <typename Visitor>
+    void forEach(Visitor visit)
+    {
+        for (auto& element : vertices_)
+        {
+            visit(element.first, element.second);
+        }
+    }
+
+private:
+    std::pmr::map<int, Vertex> vertices_;
+};
+
+
+
+template <typename Vertex>
+class DenseVertexStorage
+{
+public:
+    explicit DenseVertexStorage(std::pmr::memory_resource* resource)
+        : vertices_(resource), present_(resource), size_{0}
+    {
+    }
+
+    std::pmr::memory_resource* resource() const
+    {
+        return vertices_.get_allocator().resource();
+    }
+
+    bool accepts(int vertex) const { return vertex >= 0; }
+
+    Vertex* find(int vertex)
+    {
+        return contains(vertex) ? &vertices_[vertex] : nullptr;
+    }
+
+    const Vertex* find(int vertex) const
+    {
+        return contains(vertex) ? &vertices_[vertex] : nullptr;
+    }
+
+    // Vertices added in increasing order, the usual case, are constructed
+    // at the end of the deque; any other is moved into its empty slot.
+    template <typename... Args>
+    void emplace(int vertex, Args&&... args)
+    {
+        if (vertex >= static_cast<int>(vertices_.size()))
+        {
+            vertices_.resize(vertex);
+            present_.resize(vertex + 1, false);
+            vertices_.emplace_back(std::forward<Args>(args)...);
+        }
+        else
+        {
+            vertices_[vertex] = Vertex(std::forward<Args>(args)..., vertices_.get_allocator());
+        }
+
+        present_[vertex] = true;
+        ++size_;
+    }
+
+    // erase() leaves a tombstone behind and releases whatever the vertex
+    // object owned, such as its edge list.
+    void erase(int vertex)
+    {
+        vertices_[vertex] = Vertex{vertices_.get_allocator()};
+        present_[vertex] = false;
+        --size_;
+    }
+
+    int size() const { return size_; }
+
+    template <typename Visitor>
+    void forEach(Visitor visit) const
+    {
+        for (int vertex = 0; vertex < static_cast<int>(vertices_.size()); ++vertex)
+        {
+            if (present_[vertex])
+            {
+                visit(vertex, vertices_[vertex]);
+            }
+        }
+    }
+
+    template <typename Visitor>
+    void forEach(Visitor visit)
+    {
+        for (int vertex = 0; vertex < static_cast<int>(vertices_.size()); ++vertex)
+        {
+            if (present_[vertex])
+            {
+                visit(vertex, vertices_[vertex]);
+            }
+        }
+    }
+
+private:
+    bool contains(int vertex) const
+    {
+        return vertex >= 0 && vertex < static_cast<int>(present_.size()) && present_[vertex];
+    }
+
+private:
+    std::pmr::deque<Vertex> vertices_;
+    std::pmr::vector<bool> present_;
+    int size_;
+};
+
+
+
+#endif // DIGRAPHSTORAGE_HPP
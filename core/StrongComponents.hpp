@@ -0,0 +1,209 @@
+// StrongComponents.hpp
+//
+// ICS 46 Spring 2017
+// Project #4: Rock and Roll Stops the Traffic
+//
+// This header file declares the strongly connected components analysis
+// shared by Digraph and CompactRoadGraph.  Both hand it their edges in the
+// same compressed form: vertices are numbered 0..N-1, and the edges
+// leaving vertex v are targets[offsets[v]] through targets[offsets[v + 1] - 1].
+//
+// findStrongComponents() is Tarjan's algorithm with an explicit stack of
+// (vertex, next edge) frames in place of recursion, so a path through a
+// million vertices needs a million frames of heap memory rather than a
+// million nested calls.  It runs in O(V + E) time.
+//
+// Components are numbered in the order Tarjan's algorithm completes them,
+// which is a reverse topological order of the condensation: every edge
+// between two different components points from the higher-numbered one to
+// the lower-numbered one.
+
+#ifndef STRONGCOMPONENTS_HPP
+#define STRONGCOMPONENTS_HPP
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+
+
+// findStrongComponents() writes the component number of every vertex into
+// components, which must have room for vertexCount elements, and returns
+// the number of components.
+inline int findStrongComponents(
+    int vertexCount, const int* offsets, const int* targets, int* components)
+{
+    // A vertex that has been discovered but not yet assigned a component
+    // is exactly a vertex on Tarjan's stack, so components doubles as the
+    // on-stack flag.
+    std::vector<int> discovery(vertexCount, -1);
+    std::vector<int> lowLink(vertexCount);
+    std::vector<int> stack;
+    std::vector<std::pair<int, int>> frames;
+
+    std::fill(components, components + vertexCount, -1);
+
+    int discovered = 0;
+    int componentCount = 0;
+
+    auto discover = [&](int vertex)
+    {
+        discovery[vertex] = lowLink[vertex] = discovered++;
+        stack.push_back(vertex);
+        frames.emplace_back(vertex, offsets[vertex]);
+    };
+
+    for (int root = 0; root < vertexCount; ++root)
+    {
+        if (discovery[root] != -1)
+        {
+            continue;
+        }
+
+        discover(root);
+
+        while (!frames.empty())
+        {
+            int vertex = frames.back().first;
+            int& position = frames.back().second;
+
+            if (position < offsets[vertex + 1])
+            {
+                int target = targets[position++];
+
+                if (discovery[target] == -1)
+                {
+                    discover(target);
+                }
+                else if (components[target] == -1)
+                {
+                    lowLink[vertex] = std::min(lowLink[vertex], discovery[target]);
+                }
+
+                continue;
+            }
+
+            frames.pop_back();
+
+            if (lowLink[vertex] == discovery[vertex])
+            {
+                int member;
+
+                do
+                {
+                    member = stack.back();
+                    stack.pop_back();
+                    components[member] = componentCount;
+                }
+                while (member != vertex);
+
+                ++componentCount;
+            }
+
+            if (!frames.empty())
+            {
+                int parent = frames.back().first;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[vertex]);
+            }
+        }
+    }
+
+    return componentCount;
+}
+
+
+// condenseComponents() builds the condensation of the graph, in the same
+// compressed form as the graph itself: the components reachable by one
+// edge from component c are condensedTargets[condensedOffsets[c]] through
+// condensedTargets[condensedOffsets[c + 1] - 1], in increasing order and
+// without repeats.
+inline void condenseComponents(
+    int vertexCount, const int* offsets, const int* targets,
+    const int* components, int componentCount,
+    std::vector<int>& condensedOffsets, std::vector<int>& condensedTargets)
+{
+    // The edges between components are sorted by target and then, stably,
+    // by source with two counting sorts, which keeps the whole pass linear.
+    std::vector<int> fromComponents;
+    std::vector<int> toComponents;
+
+    for (int vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        for (int position = offsets[vertex]; position < offsets[vertex + 1]; ++position)
+        {
+            int from = components[vertex];
+            int to = components[targets[position]];
+
+            if (from != to)
+            {
+                fromComponents.push_back(from);
+                toComponents.push_back(to);
+            }
+        }
+    }
+
+    int edgeCount = static_cast<int>(toComponents.size());
+    std::vector<int> byTarget(edgeCount);
+    std::vector<int> starts(componentCount + 1, 0);
+
+    for (int to : toComponents)
+    {
+        ++starts[to + 1];
+    }
+
+    for (int component = 0; component < componentCount; ++component)
+    {
+        starts[component + 1] += starts[component];
+    }
+
+    for (int edge = 0; edge < edgeCount; ++edge)
+    {
+        byTarget[starts[toComponents[edge]]++] = edge;
+    }
+
+    condensedOffsets.assign(componentCount + 1, 0);
+
+    for (int from : fromComponents)
+    {
+        ++condensedOffsets[from + 1];
+    }
+
+    for (int component = 0; component < componentCount; ++component)
+    {
+        condensedOffsets[component + 1] += condensedOffsets[component];
+    }
+
+    std::vector<int> next(condensedOffsets.begin(), condensedOffsets.end() - 1);
+    std::vector<int> sorted(edgeCount);
+
+    for (int edge : byTarget)
+    {
+        sorted[next[fromComponents[edge]]++] = toComponents[edge];
+    }
+
+    // Repeated edges are now adjacent within each component's range, so
+    // they're squeezed out in one more pass.
+    condensedTargets.clear();
+    condensedTargets.reserve(edgeCount);
+
+    for (int component = 0; component < componentCount; ++component)
+    {
+        int begin = condensedOffsets[component];
+        int end = condensedOffsets[component + 1];
+        condensedOffsets[component] = static_cast<int>(condensedTargets.size());
+
+        for (int position = begin; position < end; ++position)
+        {
+            if (position == begin || sorted[position] != sorted[position - 1])
+            {
+                condensedTargets.push_back(sorted[position]);
+            }
+        }
+    }
+
+    condensedOffsets[componentCount] = static_cast<int>(condensedTargets.size());
+}
+
+
+
+#endif // STRONGCOMPONENTS_HPP